@@ -341,15 +341,10 @@ namespace graphene { namespace app {
                   assert( aobj != nullptr );
                   result.push_back( aobj->owner );
                   break;
-               } case impl_transaction_object_type:{
-                  const auto& aobj = dynamic_cast<const transaction_object*>(obj);
-                  assert( aobj != nullptr );
-                  flat_set<account_id_type> impacted;
-                  transaction_get_impacted_accounts( aobj->trx, impacted );
-                  result.reserve( impacted.size() );
-                  for( auto& item : impacted ) result.emplace_back(item);
+               } case impl_transaction_object_type:
+                  // dedupe entries only keep the transaction id, the operations' accounts see them in their history
                   break;
-               } case impl_blinded_balance_object_type:{
+               case impl_blinded_balance_object_type:{
                   const auto& aobj = dynamic_cast<const blinded_balance_object*>(obj);
                   assert( aobj != nullptr );
                   result.reserve( aobj->owner.account_auths.size() );
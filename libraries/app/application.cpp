@@ -471,6 +471,16 @@ namespace detail {
             _force_validate = true;
          }
 
+         if( _options->count("max-pending-transactions") )
+            _chain_db->node_properties().max_pending_transactions = _options->at("max-pending-transactions").as<uint32_t>();
+         if( _options->count("max-pending-transaction-bytes") )
+            _chain_db->node_properties().max_pending_transaction_bytes = _options->at("max-pending-transaction-bytes").as<uint64_t>();
+         if( _options->count("maintenance-threads") )
+            _chain_db->node_properties().maintenance_threads = _options->at("maintenance-threads").as<uint32_t>();
+         if( _options->count("confidential-verification-threads") )
+            _chain_db->node_properties().confidential_verification_threads =
+                  _options->at("confidential-verification-threads").as<uint32_t>();
+
          graphene::time::now();
 
          if( _options->count("api-access") )
@@ -994,6 +1004,14 @@ void application::set_program_options(boost::program_options::options_descriptio
          ("genesis-json", bpo::value<boost::filesystem::path>(), "File to read Genesis State from")
          ("dbg-init-key", bpo::value<string>(), "Block signing key to use for init witnesses, overrides genesis file")
          ("api-access", bpo::value<boost::filesystem::path>(), "JSON file specifying API permissions")
+         ("max-pending-transactions", bpo::value<uint32_t>(),
+          "Most transactions kept pending for the next block, lowest fee rates are evicted first (default: no limit)")
+         ("max-pending-transaction-bytes", bpo::value<uint64_t>(),
+          "Most packed bytes of transactions kept pending for the next block (default: no limit)")
+         ("maintenance-threads", bpo::value<uint32_t>(),
+          "Threads tallying votes at maintenance time, 0 uses one per core for large account sets (default: 0)")
+         ("confidential-verification-threads", bpo::value<uint32_t>(),
+          "Threads verifying the confidential transactions of a block, 0 uses one per core (default: 0)")
          ;
    command_line_options.add(configuration_file_options);
    command_line_options.add_options()
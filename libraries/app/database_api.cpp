@@ -26,6 +26,7 @@
 #include <graphene/chain/get_config.hpp>
 #include <graphene/chain/tournament_object.hpp>
 #include <graphene/chain/account_object.hpp>
+#include <graphene/chain/hardfork.hpp>
 
 #include <fc/bloom_filter.hpp>
 #include <fc/smart_ref_impl.hpp>
@@ -36,7 +37,9 @@
 #include <boost/rational.hpp>
 #include <boost/multiprecision/cpp_int.hpp>
 
+#include <algorithm>
 #include <cctype>
+#include <unordered_map>
 
 #include <cfenv>
 #include <iostream>
@@ -47,6 +50,81 @@ namespace graphene { namespace app {
 
 class database_api_impl;
 
+/**
+ * Caches the parts of full_account which only change when one of the account's own objects changes, so
+ * that repeated get_full_accounts polls of idle accounts do not rescan the indexes.  Votes are not cached
+ * because the voted objects (witnesses in particular) change nearly every block.
+ *
+ * Objects reverted by the undo database are not reported through changed_objects, so every account
+ * invalidated since the previous block is invalidated again once the next block is applied (this drops
+ * the effects of pending transactions which did not make it into the block), and the whole cache is
+ * dropped when the new head block does not build on the previous one.
+ */
+class full_account_cache
+{
+   public:
+      full_account_cache( graphene::chain::database& db ):_db(db){}
+
+      /** @return the cached entry for @ref account, building it if needed; votes are left empty */
+      const full_account& get( const account_object& account );
+
+      void on_objects_changed( const vector<object_id_type>& ids );
+      void on_applied_block( const signed_block& b );
+
+   private:
+      struct entry
+      {
+         full_account            data;
+         /** ids of every object the entry was built from */
+         vector<object_id_type>  objects;
+      };
+
+      entry build( const account_object& account )const;
+      void invalidate( account_id_type account );
+      void clear();
+
+      /** when the cache grows past this many accounts it is dropped and refilled by the next polls */
+      static const size_t max_entries = 10000;
+
+      graphene::chain::database&                               _db;
+      map<account_id_type, entry>                              _entries;
+      std::unordered_multimap<object_id_type, account_id_type> _object_owners;
+      flat_set<account_id_type>                                _changed_since_last_block;
+      block_id_type                                            _head_block_id;
+};
+
+/**
+ * One object_update_dispatcher is shared by every database_api attached to the same chain database.
+ * It receives the changed_objects and removed_objects signals once, looks each object up and converts
+ * it to a variant once, and hands the same payload to every attached database_api_impl.  Without it
+ * every connected client would repeat the lookup and serialization of every changed object.
+ */
+class object_update_dispatcher
+{
+   public:
+      object_update_dispatcher( graphene::chain::database& db );
+
+      /** @return the dispatcher of @ref db, creating it if no database_api is currently attached */
+      static std::shared_ptr<object_update_dispatcher> get( graphene::chain::database& db );
+
+      void add_listener( const std::shared_ptr<database_api_impl>& listener );
+
+      full_account_cache& full_accounts() { return _full_accounts; }
+
+   private:
+      void on_objects_changed( const vector<object_id_type>& ids );
+      void on_objects_removed( const vector<const object*>& objs );
+
+      /** returns the listeners which are still alive and forgets the ones which have been freed */
+      vector< std::shared_ptr<database_api_impl> > live_listeners();
+
+      graphene::chain::database&                 _db;
+      vector< std::weak_ptr<database_api_impl> > _listeners;
+      full_account_cache                         _full_accounts;
+      boost::signals2::scoped_connection         _change_connection;
+      boost::signals2::scoped_connection         _removed_connection;
+      boost::signals2::scoped_connection         _applied_block_connection;
+};
 
 class database_api_impl : public std::enable_shared_from_this<database_api_impl>
 {
@@ -66,6 +144,7 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       // Blocks and transactions
       optional<block_header> get_block_header(uint32_t block_num)const;
       optional<signed_block> get_block(uint32_t block_num)const;
+      vector<vector<char>> get_blocks(uint32_t block_num, uint32_t count)const;
       processed_transaction get_transaction( uint32_t block_num, uint32_t trx_in_block )const;
 
       // Globals
@@ -172,11 +251,18 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
          return _subscribe_filter.contains( i );
       }
 
-      void broadcast_updates( const vector<variant>& updates );
+      void broadcast_updates( const std::shared_ptr<const fc::variant>& updates );
+
+      bool has_subscribe_callback()const { return bool(_subscribe_callback); }
+      bool has_market_subscriptions()const { return !_market_subscriptions.empty(); }
 
-      /** called every time a block is applied to report the objects that were changed */
-      void on_objects_changed(const vector<object_id_type>& ids);
-      void on_objects_removed(const vector<const object*>& objs);
+      /**
+       * called by the object_update_dispatcher every time objects are changed or removed; @ref objs holds
+       * the objects (nullptr for ids which no longer exist) and @ref updates the variant shared by all
+       * subscribers, or nullptr when no attached api has a subscribe callback
+       */
+      void on_objects_changed( const vector<const object*>& objs, const std::shared_ptr<const fc::variant>& updates );
+      void on_objects_removed( const vector<const object*>& objs, const std::shared_ptr<const fc::variant>& updates );
       void on_applied_block();
 
       mutable fc::bloom_filter                               _subscribe_filter;
@@ -184,8 +270,7 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       std::function<void(const fc::variant&)> _pending_trx_callback;
       std::function<void(const fc::variant&)> _block_applied_callback;
 
-      boost::signals2::scoped_connection                                                                                           _change_connection;
-      boost::signals2::scoped_connection                                                                                           _removed_connection;
+      std::shared_ptr<object_update_dispatcher>                                                                                    _dispatcher;
       boost::signals2::scoped_connection                                                                                           _applied_block_connection;
       boost::signals2::scoped_connection                                                                                           _pending_trx_connection;
       map< pair<asset_id_type,asset_id_type>, std::function<void(const variant&)> >      _market_subscriptions;
@@ -199,19 +284,17 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
 //////////////////////////////////////////////////////////////////////
 
 database_api::database_api( graphene::chain::database& db )
-   : my( new database_api_impl( db ) ) {}
+   : my( new database_api_impl( db ) )
+{
+   my->_dispatcher = object_update_dispatcher::get( db );
+   my->_dispatcher->add_listener( my );
+}
 
 database_api::~database_api() {}
 
 database_api_impl::database_api_impl( graphene::chain::database& db ):_db(db)
 {
    wlog("creating database api ${x}", ("x",int64_t(this)) );
-   _change_connection = _db.changed_objects.connect([this](const vector<object_id_type>& ids) {
-                                on_objects_changed(ids);
-                                });
-   _removed_connection = _db.removed_objects.connect([this](const vector<const object*>& objs) {
-                                on_objects_removed(objs);
-                                });
    _applied_block_connection = _db.applied_block.connect([this](const signed_block&){ on_applied_block(); });
 
    _pending_trx_connection = _db.on_pending_transaction.connect([this](const signed_transaction& trx ){
@@ -350,6 +433,30 @@ optional<signed_block> database_api_impl::get_block(uint32_t block_num)const
    return _db.fetch_block_by_number(block_num);
 }
 
+vector<vector<char>> database_api::get_blocks(uint32_t block_num, uint32_t count)const
+{
+   return my->get_blocks( block_num, count );
+}
+
+vector<vector<char>> database_api_impl::get_blocks(uint32_t block_num, uint32_t count)const
+{
+   FC_ASSERT( count <= 1000 );
+   const size_t max_total_size = 4*1024*1024;
+
+   vector<vector<char>> result;
+   result.reserve( count );
+   size_t total_size = 0;
+   for( uint32_t num = block_num; num - block_num < count && total_size < max_total_size; ++num )
+   {
+      auto packed = _db.fetch_packed_block_by_number( num );
+      if( !packed )
+         break;
+      total_size += packed->size();
+      result.emplace_back( std::move( *packed ) );
+   }
+   return result;
+}
+
 processed_transaction database_api::get_transaction( uint32_t block_num, uint32_t trx_in_block )const
 {
    return my->get_transaction( block_num, trx_in_block );
@@ -534,6 +641,10 @@ std::map<std::string, full_account> database_api_impl::get_full_accounts( const
    idump((names_or_ids));
    std::map<std::string, full_account> results;
 
+   // resolve the whole batch first so that an account requested both by name and by id is assembled once
+   const auto& by_name_idx = _db.get_index_type<account_index>().indices().get<by_name_hash>();
+   vector< pair<const std::string*, const account_object*> > requested;
+   requested.reserve( names_or_ids.size() );
    for (const std::string& account_name_or_id : names_or_ids)
    {
       const account_object* account = nullptr;
@@ -541,85 +652,36 @@ std::map<std::string, full_account> database_api_impl::get_full_accounts( const
          account = _db.find(fc::variant(account_name_or_id).as<account_id_type>());
       else
       {
-         const auto& idx = _db.get_index_type<account_index>().indices().get<by_name>();
-         auto itr = idx.find(account_name_or_id);
-         if (itr != idx.end())
+         auto itr = by_name_idx.find(account_name_or_id);
+         if (itr != by_name_idx.end())
             account = &*itr;
       }
-      if (account == nullptr)
-         continue;
+      if (account != nullptr)
+         requested.emplace_back( &account_name_or_id, account );
+   }
 
+   full_account_cache& cache = _dispatcher->full_accounts();
+   map<account_id_type, const std::string*> assembled;
+   for( const auto& item : requested )
+   {
+      const account_object* account = item.second;
       if( subscribe )
       {
          ilog( "subscribe to ${id}", ("id",account->name) );
          subscribe_to_item( account->id );
       }
 
-      // fc::mutable_variant_object full_account;
-      full_account acnt;
-      acnt.account = *account;
-      acnt.statistics = account->statistics(_db);
-      acnt.registrar_name = account->registrar(_db).name;
-      acnt.referrer_name = account->referrer(_db).name;
-      acnt.lifetime_referrer_name = account->lifetime_referrer(_db).name;
-      acnt.votes = lookup_vote_ids( vector<vote_id_type>(account->options.votes.begin(),account->options.votes.end()) );
-
-      // Add the account itself, its statistics object, cashback balance, and referral account names
-      /*
-      full_account("account", *account)("statistics", account->statistics(_db))
-            ("registrar_name", account->registrar(_db).name)("referrer_name", account->referrer(_db).name)
-            ("lifetime_referrer_name", account->lifetime_referrer(_db).name);
-            */
-      if (account->cashback_vb)
-      {
-         acnt.cashback_balance = account->cashback_balance(_db);
-      }
-      // Add the account's proposals
-      const auto& proposal_idx = _db.get_index_type<proposal_index>();
-      const auto& pidx = dynamic_cast<const primary_index<proposal_index>&>(proposal_idx);
-      const auto& proposals_by_account = pidx.get_secondary_index<graphene::chain::required_approval_index>();
-      auto  required_approvals_itr = proposals_by_account._account_to_proposals.find( account->id );
-      if( required_approvals_itr != proposals_by_account._account_to_proposals.end() )
+      full_account& acnt = results[*item.first];
+      auto itr = assembled.find( account->id );
+      if( itr != assembled.end() )
       {
-         acnt.proposals.reserve( required_approvals_itr->second.size() );
-         for( auto proposal_id : required_approvals_itr->second )
-            acnt.proposals.push_back( proposal_id(_db) );
+         acnt = results[*itr->second];
+         continue;
       }
 
-
-      // Add the account's balances
-      auto balance_range = _db.get_index_type<account_balance_index>().indices().get<by_account_asset>().equal_range(boost::make_tuple(account->id));
-      //vector<account_balance_object> balances;
-      std::for_each(balance_range.first, balance_range.second,
-                    [&acnt](const account_balance_object& balance) {
-                       acnt.balances.emplace_back(balance);
-                    });
-
-      // Add the account's vesting balances
-      auto vesting_range = _db.get_index_type<vesting_balance_index>().indices().get<by_account>().equal_range(account->id);
-      std::for_each(vesting_range.first, vesting_range.second,
-                    [&acnt](const vesting_balance_object& balance) {
-                       acnt.vesting_balances.emplace_back(balance);
-                    });
-
-      // Add the account's orders
-      auto order_range = _db.get_index_type<limit_order_index>().indices().get<by_account>().equal_range(account->id);
-      std::for_each(order_range.first, order_range.second,
-                    [&acnt] (const limit_order_object& order) {
-                       acnt.limit_orders.emplace_back(order);
-                    });
-      auto call_range = _db.get_index_type<call_order_index>().indices().get<by_account>().equal_range(account->id);
-      std::for_each(call_range.first, call_range.second,
-                    [&acnt] (const call_order_object& call) {
-                       acnt.call_orders.emplace_back(call);
-                    });
-
-      auto pending_payouts_range = 
-         _db.get_index_type<pending_dividend_payout_balance_for_holder_object_index>().indices().get<by_account_dividend_payout>().equal_range(boost::make_tuple(account->id));
-
-      std::copy(pending_payouts_range.first, pending_payouts_range.second, std::back_inserter(acnt.pending_dividend_payments));
-
-      results[account_name_or_id] = acnt;
+      acnt = cache.get( *account );
+      acnt.votes = lookup_vote_ids( vector<vote_id_type>(account->options.votes.begin(),account->options.votes.end()) );
+      assembled[account->id] = item.first;
    }
    return results;
 }
@@ -631,7 +693,7 @@ optional<account_object> database_api::get_account_by_name( string name )const
 
 optional<account_object> database_api_impl::get_account_by_name( string name )const
 {
-   const auto& idx = _db.get_index_type<account_index>().indices().get<by_name>();
+   const auto& idx = _db.get_index_type<account_index>().indices().get<by_name_hash>();
    auto itr = idx.find(name);
    if (itr != idx.end())
       return *itr;
@@ -666,7 +728,7 @@ vector<optional<account_object>> database_api::lookup_account_names(const vector
 
 vector<optional<account_object>> database_api_impl::lookup_account_names(const vector<string>& account_names)const
 {
-   const auto& accounts_by_name = _db.get_index_type<account_index>().indices().get<by_name>();
+   const auto& accounts_by_name = _db.get_index_type<account_index>().indices().get<by_name_hash>();
    vector<optional<account_object> > result;
    result.reserve(account_names.size());
    std::transform(account_names.begin(), account_names.end(), std::back_inserter(result),
@@ -750,7 +812,7 @@ vector<asset> database_api::get_named_account_balances(const std::string& name,
 
 vector<asset> database_api_impl::get_named_account_balances(const std::string& name, const flat_set<asset_id_type>& assets) const
 {
-   const auto& accounts_by_name = _db.get_index_type<account_index>().indices().get<by_name>();
+   const auto& accounts_by_name = _db.get_index_type<account_index>().indices().get<by_name_hash>();
    auto itr = accounts_by_name.find(name);
    FC_ASSERT( itr != accounts_by_name.end() );
    return get_account_balances(itr->get_id(), assets);
@@ -1583,7 +1645,8 @@ bool database_api_impl::verify_authority( const signed_transaction& trx )const
    trx.verify_authority( _db.get_chain_id(),
                          [&]( account_id_type id ){ return &id(_db).active; },
                          [&]( account_id_type id ){ return &id(_db).owner; },
-                          _db.get_global_properties().parameters.max_authority_depth );
+                          _db.get_global_properties().parameters.max_authority_depth,
+                          _db.head_block_time() < HARDFORK_ADDRESS_AUTH_TIME );
    return true;
 }
 
@@ -1600,7 +1663,7 @@ bool database_api_impl::verify_account_authority( const string& name_or_id, cons
       account = _db.find(fc::variant(name_or_id).as<account_id_type>());
    else
    {
-      const auto& idx = _db.get_index_type<account_index>().indices().get<by_name>();
+      const auto& idx = _db.get_index_type<account_index>().indices().get<by_name_hash>();
       auto itr = idx.find(name_or_id);
       if (itr != idx.end())
          account = &*itr;
@@ -1857,34 +1920,315 @@ vector<tournament_id_type> database_api_impl::get_registered_tournaments(account
    return tournament_ids;
 }
 
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Object update dispatcher                                         //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+object_update_dispatcher::object_update_dispatcher( graphene::chain::database& db ):_db(db),_full_accounts(db)
+{
+   _change_connection = _db.changed_objects.connect([this](const vector<object_id_type>& ids) {
+                                on_objects_changed(ids);
+                                });
+   _removed_connection = _db.removed_objects.connect([this](const vector<const object*>& objs) {
+                                on_objects_removed(objs);
+                                });
+   _applied_block_connection = _db.applied_block.connect([this](const signed_block& b) {
+                                _full_accounts.on_applied_block(b);
+                                });
+}
+
+std::shared_ptr<object_update_dispatcher> object_update_dispatcher::get( graphene::chain::database& db )
+{
+   // database_api instances are created and destroyed on the thread which owns the database
+   static std::map< const graphene::chain::database*, std::weak_ptr<object_update_dispatcher> > dispatchers;
+
+   auto& weak = dispatchers[&db];
+   auto dispatcher = weak.lock();
+   if( !dispatcher )
+   {
+      dispatcher = std::make_shared<object_update_dispatcher>( db );
+      weak = dispatcher;
+   }
+   return dispatcher;
+}
+
+void object_update_dispatcher::add_listener( const std::shared_ptr<database_api_impl>& listener )
+{
+   _listeners.push_back( listener );
+}
+
+vector< std::shared_ptr<database_api_impl> > object_update_dispatcher::live_listeners()
+{
+   vector< std::shared_ptr<database_api_impl> > result;
+   result.reserve( _listeners.size() );
+   auto itr = std::remove_if( _listeners.begin(), _listeners.end(), [&result]( const std::weak_ptr<database_api_impl>& weak ) {
+      auto listener = weak.lock();
+      if( !listener )
+         return true;
+      result.push_back( std::move(listener) );
+      return false;
+   });
+   _listeners.erase( itr, _listeners.end() );
+   return result;
+}
+
+void object_update_dispatcher::on_objects_changed( const vector<object_id_type>& ids )
+{
+   _full_accounts.on_objects_changed( ids );
+
+   auto listeners = live_listeners();
+
+   bool need_updates = false;
+   bool need_objects = false;
+   for( const auto& listener : listeners )
+   {
+      need_updates |= listener->has_subscribe_callback();
+      need_objects |= listener->has_subscribe_callback() || listener->has_market_subscriptions();
+   }
+   if( !need_objects )
+      return;
+
+   vector<const object*> objs;
+   objs.reserve( ids.size() );
+   for( const auto& id : ids )
+      objs.push_back( _db.find_object( id ) );
+
+   std::shared_ptr<const fc::variant> updates;
+   if( need_updates )
+   {
+      vector<variant> result;
+      result.reserve( ids.size() );
+      for( size_t i = 0; i < ids.size(); ++i )
+      {
+         if( objs[i] )
+            result.emplace_back( objs[i]->to_variant() );
+         else
+            result.emplace_back( ids[i] ); // send just the id to indicate removal
+      }
+      updates = std::make_shared<fc::variant>( std::move(result) );
+   }
+
+   for( const auto& listener : listeners )
+      listener->on_objects_changed( objs, updates );
+}
+
+void object_update_dispatcher::on_objects_removed( const vector<const object*>& objs )
+{
+   if( objs.empty() )
+      return;
+
+   auto listeners = live_listeners();
+
+   bool need_updates = false;
+   bool need_objects = false;
+   for( const auto& listener : listeners )
+   {
+      need_updates |= listener->has_subscribe_callback();
+      need_objects |= listener->has_subscribe_callback() || listener->has_market_subscriptions();
+   }
+   if( !need_objects )
+      return;
+
+   std::shared_ptr<const fc::variant> updates;
+   if( need_updates )
+   {
+      vector<variant> result;
+      result.reserve( objs.size() );
+      for( auto obj : objs )
+         result.emplace_back( obj->id );
+      updates = std::make_shared<fc::variant>( std::move(result) );
+   }
+
+   for( const auto& listener : listeners )
+      listener->on_objects_removed( objs, updates );
+}
+
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Full account cache                                               //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+const full_account& full_account_cache::get( const account_object& account )
+{
+   auto itr = _entries.find( account.id );
+   if( itr != _entries.end() )
+      return itr->second.data;
+
+   if( _entries.size() >= max_entries )
+      clear();
+
+   entry e = build( account );
+   for( const auto& id : e.objects )
+      _object_owners.emplace( id, account.id );
+   return _entries.emplace( account.id, std::move(e) ).first->second.data;
+}
+
+full_account_cache::entry full_account_cache::build( const account_object& account )const
+{
+   entry result;
+   full_account& acnt = result.data;
+   acnt.account = account;
+   acnt.statistics = account.statistics(_db);
+   acnt.registrar_name = account.registrar(_db).name;
+   acnt.referrer_name = account.referrer(_db).name;
+   acnt.lifetime_referrer_name = account.lifetime_referrer(_db).name;
+   result.objects.push_back( account.id );
+   result.objects.push_back( account.statistics );
+
+   if (account.cashback_vb)
+   {
+      acnt.cashback_balance = account.cashback_balance(_db);
+      result.objects.push_back( *account.cashback_vb );
+   }
+
+   // Add the account's proposals
+   const auto& proposal_idx = _db.get_index_type<proposal_index>();
+   const auto& pidx = dynamic_cast<const primary_index<proposal_index>&>(proposal_idx);
+   const auto& proposals_by_account = pidx.get_secondary_index<graphene::chain::required_approval_index>();
+   auto  required_approvals_itr = proposals_by_account._account_to_proposals.find( account.id );
+   if( required_approvals_itr != proposals_by_account._account_to_proposals.end() )
+   {
+      acnt.proposals.reserve( required_approvals_itr->second.size() );
+      for( auto proposal_id : required_approvals_itr->second )
+         acnt.proposals.push_back( proposal_id(_db) );
+   }
+
+   // Add the account's balances
+   auto balance_range = _db.get_index_type<account_balance_index>().indices().get<by_account_asset>().equal_range(boost::make_tuple(account.id));
+   std::copy(balance_range.first, balance_range.second, std::back_inserter(acnt.balances));
+
+   // Add the account's vesting balances
+   auto vesting_range = _db.get_index_type<vesting_balance_index>().indices().get<by_account>().equal_range(account.id);
+   std::copy(vesting_range.first, vesting_range.second, std::back_inserter(acnt.vesting_balances));
+
+   // Add the account's orders
+   auto order_range = _db.get_index_type<limit_order_index>().indices().get<by_account>().equal_range(account.id);
+   std::copy(order_range.first, order_range.second, std::back_inserter(acnt.limit_orders));
+   auto call_range = _db.get_index_type<call_order_index>().indices().get<by_account>().equal_range(account.id);
+   std::copy(call_range.first, call_range.second, std::back_inserter(acnt.call_orders));
+
+   auto pending_payouts_range =
+      _db.get_index_type<pending_dividend_payout_balance_for_holder_object_index>().indices().get<by_account_dividend_payout>().equal_range(boost::make_tuple(account.id));
+   std::copy(pending_payouts_range.first, pending_payouts_range.second, std::back_inserter(acnt.pending_dividend_payments));
+
+   for( const auto& o : acnt.proposals )                 result.objects.push_back( o.id );
+   for( const auto& o : acnt.balances )                  result.objects.push_back( o.id );
+   for( const auto& o : acnt.vesting_balances )          result.objects.push_back( o.id );
+   for( const auto& o : acnt.limit_orders )              result.objects.push_back( o.id );
+   for( const auto& o : acnt.call_orders )               result.objects.push_back( o.id );
+   for( const auto& o : acnt.pending_dividend_payments ) result.objects.push_back( o.id );
+
+   return result;
+}
+
+void full_account_cache::on_objects_changed( const vector<object_id_type>& ids )
+{
+   if( _entries.empty() )
+      return;
+
+   flat_set<account_id_type> affected;
+   for( const auto& id : ids )
+   {
+      auto range = _object_owners.equal_range( id );
+      if( range.first != range.second )
+      {
+         for( auto itr = range.first; itr != range.second; ++itr )
+            affected.insert( itr->second );
+         continue;
+      }
+
+      // objects which are not part of any entry yet, i.e. newly created ones
+      const object* obj = _db.find_object( id );
+      if( obj == nullptr )
+         continue;
+      if( auto balance = dynamic_cast<const account_balance_object*>(obj) )
+         affected.insert( balance->owner );
+      else if( auto vesting = dynamic_cast<const vesting_balance_object*>(obj) )
+         affected.insert( vesting->owner );
+      else if( auto order = dynamic_cast<const limit_order_object*>(obj) )
+         affected.insert( order->seller );
+      else if( auto call = dynamic_cast<const call_order_object*>(obj) )
+         affected.insert( call->borrower );
+      else if( auto payout = dynamic_cast<const pending_dividend_payout_balance_for_holder_object*>(obj) )
+         affected.insert( payout->owner );
+      else if( auto proposal = dynamic_cast<const proposal_object*>(obj) )
+      {
+         affected.insert( proposal->required_active_approvals.begin(), proposal->required_active_approvals.end() );
+         affected.insert( proposal->required_owner_approvals.begin(), proposal->required_owner_approvals.end() );
+         affected.insert( proposal->available_active_approvals.begin(), proposal->available_active_approvals.end() );
+         affected.insert( proposal->available_owner_approvals.begin(), proposal->available_owner_approvals.end() );
+      }
+   }
+
+   for( const auto& account : affected )
+   {
+      invalidate( account );
+      _changed_since_last_block.insert( account );
+   }
+}
+
+void full_account_cache::on_applied_block( const signed_block& b )
+{
+   if( b.previous != _head_block_id )
+      clear();
+   else
+      for( const auto& account : _changed_since_last_block )
+         invalidate( account );
+   _changed_since_last_block.clear();
+   _head_block_id = b.id();
+}
+
+void full_account_cache::invalidate( account_id_type account )
+{
+   auto itr = _entries.find( account );
+   if( itr == _entries.end() )
+      return;
+
+   for( const auto& id : itr->second.objects )
+   {
+      auto range = _object_owners.equal_range( id );
+      for( auto owner = range.first; owner != range.second; )
+      {
+         if( owner->second == account )
+            owner = _object_owners.erase( owner );
+         else
+            ++owner;
+      }
+   }
+   _entries.erase( itr );
+}
+
+void full_account_cache::clear()
+{
+   _entries.clear();
+   _object_owners.clear();
+}
+
 //////////////////////////////////////////////////////////////////////
 //                                                                  //
 // Private methods                                                  //
 //                                                                  //
 //////////////////////////////////////////////////////////////////////
 
-void database_api_impl::broadcast_updates( const vector<variant>& updates )
+void database_api_impl::broadcast_updates( const std::shared_ptr<const fc::variant>& updates )
 {
-   if( updates.size() ) {
+   if( updates ) {
       auto capture_this = shared_from_this();
       fc::async([capture_this,updates](){
-          capture_this->_subscribe_callback( fc::variant(updates) );
+          if( capture_this->_subscribe_callback )
+             capture_this->_subscribe_callback( *updates );
       });
    }
 }
 
-void database_api_impl::on_objects_removed( const vector<const object*>& objs )
+void database_api_impl::on_objects_removed( const vector<const object*>& objs, const std::shared_ptr<const fc::variant>& updates )
 {
    /// we need to ensure the database_api is not deleted for the life of the async operation
    if( _subscribe_callback )
-   {
-      vector<variant>    updates;
-      updates.reserve(objs.size());
-
-      for( auto obj : objs )
-         updates.emplace_back( obj->id );
       broadcast_updates( updates );
-   }
 
    if( _market_subscriptions.size() )
    {
@@ -1914,52 +2258,35 @@ void database_api_impl::on_objects_removed( const vector<const object*>& objs )
    }
 }
 
-void database_api_impl::on_objects_changed(const vector<object_id_type>& ids)
+void database_api_impl::on_objects_changed( const vector<const object*>& objs, const std::shared_ptr<const fc::variant>& updates )
 {
-   vector<variant>    updates;
    map< pair<asset_id_type, asset_id_type>,  vector<variant> > market_broadcast_queue;
 
-   for(auto id : ids)
+   if( _market_subscriptions.size() )
    {
-      const object* obj = nullptr;
-      if( _subscribe_callback )
+      for( const object* obj : objs )
       {
-         obj = _db.find_object( id );
-         if( obj )
-         {
-            updates.emplace_back( obj->to_variant() );
-         }
-         else
-         {
-            updates.emplace_back(id); // send just the id to indicate removal
-         }
-      }
-
-      if( _market_subscriptions.size() )
-      {
-         if( !_subscribe_callback )
-            obj = _db.find_object( id );
-         if( obj )
+         const limit_order_object* order = dynamic_cast<const limit_order_object*>(obj);
+         if( order )
          {
-            const limit_order_object* order = dynamic_cast<const limit_order_object*>(obj);
-            if( order )
-            {
-               auto sub = _market_subscriptions.find( order->get_market() );
-               if( sub != _market_subscriptions.end() )
-                  market_broadcast_queue[order->get_market()].emplace_back( order->id );
-            }
+            auto sub = _market_subscriptions.find( order->get_market() );
+            if( sub != _market_subscriptions.end() )
+               market_broadcast_queue[order->get_market()].emplace_back( order->id );
          }
       }
    }
 
+   if( !(_subscribe_callback && updates) && market_broadcast_queue.empty() )
+      return;
+
    auto capture_this = shared_from_this();
 
    /// pushing the future back / popping the prior future if it is complete.
    /// if a connection hangs then this could get backed up and result in
    /// a failure to exit cleanly.
    fc::async([capture_this,this,updates,market_broadcast_queue](){
-      if( _subscribe_callback ) 
-         _subscribe_callback( updates );
+      if( _subscribe_callback && updates )
+         _subscribe_callback( *updates );
 
       for( const auto& item : market_broadcast_queue )
       {
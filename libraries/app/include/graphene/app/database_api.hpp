@@ -166,6 +166,17 @@ class database_api
        */
       optional<signed_block> get_block(uint32_t block_num)const;
 
+      /**
+       * @brief Retrieve a range of consecutive blocks, each packed with fc::raw::pack
+       * @param block_num Height of the first block to be returned
+       * @param count Number of blocks to return, at most 1000
+       * @return the blocks starting at block_num, in order
+       *
+       * Fewer than count blocks are returned when the range runs past the head block or when the blocks
+       * returned so far reach 4 MiB; the caller continues with the next block number.
+       */
+      vector<vector<char>> get_blocks(uint32_t block_num, uint32_t count)const;
+
       /**
        * @brief used to fetch an individual transaction.
        */
@@ -603,6 +614,7 @@ FC_API(graphene::app::database_api,
    // Blocks and transactions
    (get_block_header)
    (get_block)
+   (get_blocks)
    (get_transaction)
    (get_recent_transaction_by_id)
 
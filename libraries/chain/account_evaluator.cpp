@@ -131,8 +131,8 @@ void_result account_create_evaluator::do_evaluate( const account_create_operatio
    auto& acnt_indx = d.get_index_type<account_index>();
    if( op.name.size() )
    {
-      auto current_account_itr = acnt_indx.indices().get<by_name>().find( op.name );
-      FC_ASSERT( current_account_itr == acnt_indx.indices().get<by_name>().end() );
+      auto current_account_itr = acnt_indx.indices().get<by_name_hash>().find( op.name );
+      FC_ASSERT( current_account_itr == acnt_indx.indices().get<by_name_hash>().end() );
    }
 
    return void_result();
@@ -158,3 +158,43 @@ string asset_object::amount_to_string(share_type amount) const
       result += "." + fc::to_string(scaled_precision.value + decimals).erase(0,1);
    return result;
 }
+
+void bitasset_feed_expiration_index::object_inserted( const object& obj )
+{
+   assert( dynamic_cast<const asset_bitasset_data_object*>(&obj) ); // for debug only
+   const asset_bitasset_data_object& bitasset = static_cast<const asset_bitasset_data_object&>(obj);
+   feed_expirations.insert( std::make_pair( bitasset.feed_expiration_time(), bitasset.asset_id ) );
+   changed_assets.insert( bitasset.asset_id );
+}
+
+void bitasset_feed_expiration_index::object_removed( const object& obj )
+{
+   assert( dynamic_cast<const asset_bitasset_data_object*>(&obj) ); // for debug only
+   const asset_bitasset_data_object& bitasset = static_cast<const asset_bitasset_data_object&>(obj);
+   feed_expirations.erase( std::make_pair( bitasset.feed_expiration_time(), bitasset.asset_id ) );
+}
+
+void bitasset_feed_expiration_index::about_to_modify( const object& before )
+{
+   assert( dynamic_cast<const asset_bitasset_data_object*>(&before) ); // for debug only
+   const asset_bitasset_data_object& bitasset = static_cast<const asset_bitasset_data_object&>(before);
+   feed_expirations.erase( std::make_pair( bitasset.feed_expiration_time(), bitasset.asset_id ) );
+}
+
+void bitasset_feed_expiration_index::object_modified( const object& after )
+{
+   object_inserted( after );
+}
+
+void market_issued_asset_change_index::object_inserted( const object& obj )
+{
+   assert( dynamic_cast<const asset_object*>(&obj) ); // for debug only
+   const asset_object& a = static_cast<const asset_object&>(obj);
+   if( a.is_market_issued() )
+      changed_assets.insert( a.get_id() );
+}
+
+void market_issued_asset_change_index::object_modified( const object& after )
+{
+   object_inserted( after );
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/authority_resolver.hpp>
+
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/hardfork.hpp>
+
+namespace graphene { namespace chain {
+
+void authority_resolver::verify_authority( const database& db, const transaction& trx, const flat_set<public_key_type>& keys,
+                                           uint32_t max_recursion_depth )
+{
+   verified_authority v;
+   vector<authority> other;
+   trx.get_required_authorities( v.required_active, v.required_owner, other );
+   v.max_recursion_depth = max_recursion_depth;
+   v.unmatched_addresses_signed = db.head_block_time() < HARDFORK_ADDRESS_AUTH_TIME;
+   v.keys = keys;
+
+   if( other.empty() && _verified.find( v ) != _verified.end() )
+   {
+      ++_checks_avoided;
+      return;
+   }
+
+   ++_checks_performed;
+   flat_set<account_id_type> fetched;
+   auto get_active = [&]( account_id_type id ) -> const authority* {
+      fetched.insert( id );
+      return &id(db).active;
+   };
+   auto get_owner = [&]( account_id_type id ) -> const authority* {
+      fetched.insert( id );
+      return &id(db).owner;
+   };
+   graphene::chain::verify_authority( trx.operations, keys, get_active, get_owner, max_recursion_depth,
+                                      false, flat_set<account_id_type>(), flat_set<account_id_type>(),
+                                      v.unmatched_addresses_signed );
+
+   if( !other.empty() )
+      return;
+   if( _verified.size() >= max_verified )
+      clear();
+   _fetched_accounts.insert( fetched.begin(), fetched.end() );
+   _verified.insert( std::move( v ) );
+}
+
+void authority_resolver::object_removed( const object& obj )
+{
+   account_changed( obj.id );
+}
+
+void authority_resolver::object_modified( const object& after )
+{
+   account_changed( after.id );
+}
+
+void authority_resolver::account_changed( account_id_type account )
+{
+   if( _fetched_accounts.find( account ) != _fetched_accounts.end() )
+      clear();
+}
+
+void authority_resolver::clear()
+{
+   _verified.clear();
+   _fetched_accounts.clear();
+}
+
+} } // graphene::chain
@@ -29,15 +29,25 @@
 #include <graphene/chain/vesting_balance_object.hpp>
 #include <graphene/chain/witness_object.hpp>
 
+#include <algorithm>
+
 namespace graphene { namespace chain {
 
 asset database::get_balance(account_id_type owner, asset_id_type asset_id) const
 {
-   auto& index = get_index_type<account_balance_index>().indices().get<by_account_asset>();
+   const account_balance_object* balance = find_balance_object(owner, asset_id);
+   if( balance == nullptr )
+      return asset(0, asset_id);
+   return balance->get_balance();
+}
+
+const account_balance_object* database::find_balance_object(account_id_type owner, asset_id_type asset_id) const
+{
+   auto& index = get_index_type<account_balance_index>().indices().get<by_account_asset_hash>();
    auto itr = index.find(boost::make_tuple(owner, asset_id));
    if( itr == index.end() )
-      return asset(0, asset_id);
-   return itr->get_balance();
+      return nullptr;
+   return &*itr;
 }
 
 asset database::get_balance(const account_object& owner, const asset_object& asset_obj) const
@@ -55,27 +65,47 @@ void database::adjust_balance(account_id_type account, asset delta )
    if( delta.amount == 0 )
       return;
 
-   auto& index = get_index_type<account_balance_index>().indices().get<by_account_asset>();
-   auto itr = index.find(boost::make_tuple(account, delta.asset_id));
-   if(itr == index.end())
+   const account_balance_object* balance = nullptr;
+   for( const touched_balance& t : _touched_balances )
+   {
+      if( t.owner == account && t.asset_type == delta.asset_id )
+      {
+         balance = find(t.id);
+         if( balance != nullptr && (balance->owner != account || balance->asset_type != delta.asset_id) )
+            balance = nullptr;
+         break;
+      }
+   }
+   if( balance == nullptr )
+      balance = find_balance_object(account, delta.asset_id);
+
+   if( balance == nullptr )
    {
       FC_ASSERT( delta.amount > 0, "Insufficient Balance: ${a}'s balance of ${b} is less than required ${r}", 
                  ("a",account(*this).name)
                  ("b",to_pretty_string(asset(0,delta.asset_id)))
                  ("r",to_pretty_string(-delta)));
-      create<account_balance_object>([account,&delta](account_balance_object& b) {
+      balance = &create<account_balance_object>([account,&delta](account_balance_object& b) {
          b.owner = account;
          b.asset_type = delta.asset_id;
          b.balance = delta.amount.value;
       });
    } else {
       if( delta.amount < 0 )
-         FC_ASSERT( itr->get_balance() >= -delta, "Insufficient Balance: ${a}'s balance of ${b} is less than required ${r}", ("a",account(*this).name)("b",to_pretty_string(itr->get_balance()))("r",to_pretty_string(-delta)));
-      modify(*itr, [delta](account_balance_object& b) {
+         FC_ASSERT( balance->get_balance() >= -delta, "Insufficient Balance: ${a}'s balance of ${b} is less than required ${r}", ("a",account(*this).name)("b",to_pretty_string(balance->get_balance()))("r",to_pretty_string(-delta)));
+      modify(*balance, [delta](account_balance_object& b) {
          b.adjust_balance(delta);
       });
    }
 
+   auto touched = std::find_if( _touched_balances.begin(), _touched_balances.end(), [&]( const touched_balance& t ) {
+      return t.owner == account && t.asset_type == delta.asset_id;
+   });
+   if( touched != _touched_balances.end() )
+      touched->id = balance->id;
+   else if( _touched_balances.size() < max_touched_balances )
+      _touched_balances.push_back( touched_balance{ account, delta.asset_id, balance->id } );
+
 } FC_CAPTURE_AND_RETHROW( (account)(delta) ) }
 
 optional< vesting_balance_id_type > database::deposit_lazy_vesting(
@@ -35,8 +35,14 @@
 #include <graphene/chain/protocol/fee_schedule.hpp>
 #include <graphene/chain/exceptions.hpp>
 #include <graphene/chain/evaluator.hpp>
+#include <graphene/db/pack_buffer.hpp>
 
 #include <fc/smart_ref_impl.hpp>
+#include <fc/uint128.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <thread>
 
 namespace graphene { namespace chain {
 
@@ -78,12 +84,35 @@ optional<signed_block> database::fetch_block_by_number( uint32_t num )const
    return optional<signed_block>();
 }
 
-const signed_transaction& database::get_recent_transaction(const transaction_id_type& trx_id) const
+optional<vector<char>> database::fetch_packed_block_by_number( uint32_t num )const
+{
+   auto results = _fork_db.fetch_block_by_number(num);
+   if( results.size() == 1 )
+      return results[0]->packed_data();
+   return _block_id_to_block.fetch_packed_by_number(num);
+}
+
+signed_transaction database::get_recent_transaction(const transaction_id_type& trx_id) const
 {
    auto& index = get_index_type<transaction_index>().indices().get<by_trx_id>();
    auto itr = index.find(trx_id);
-   FC_ASSERT(itr != index.end());
-   return itr->trx;
+   if( itr == index.end() )
+      FC_THROW_EXCEPTION( fc::key_not_found_exception, "transaction ${id} is not recent", ("id",trx_id) );
+
+   const auto& pending_index = _pending_tx.indices().get<by_trx_id>();
+   auto pending_itr = pending_index.find(trx_id);
+   if( pending_itr != pending_index.end() )
+      return pending_itr->trx;
+   // applied on top of the head block but no longer pending
+   if( itr->block_num > head_block_num() )
+      FC_THROW_EXCEPTION( fc::key_not_found_exception, "transaction ${id} is no longer pending", ("id",trx_id) );
+
+   optional<signed_block> block = fetch_block_by_number(itr->block_num);
+   FC_ASSERT( block.valid() && itr->trx_in_block < block->transactions.size(), "transaction is not in a known block",
+              ("block_num",itr->block_num)("trx_in_block",itr->trx_in_block) );
+   const signed_transaction& trx = block->transactions[itr->trx_in_block];
+   FC_ASSERT( trx.id() == trx_id );
+   return trx;
 }
 
 std::vector<block_id_type> database::get_block_ids_on_fork(block_id_type head_of_fork) const
@@ -156,7 +185,7 @@ bool database::_push_block(const signed_block& new_block)
                 try {
                    undo_database::session session = _undo_db.start_undo_session();
                    apply_block( (*ritr)->data, skip );
-                   _block_id_to_block.store( (*ritr)->id, (*ritr)->data );
+                   _block_id_to_block.store( (*ritr)->id, (*ritr)->packed_data() );
                    session.commit();
                 }
                 catch ( const fc::exception& e ) { except = e; }
@@ -180,7 +209,7 @@ bool database::_push_block(const signed_block& new_block)
                    {
                       auto session = _undo_db.start_undo_session();
                       apply_block( (*ritr)->data, skip );
-                      _block_id_to_block.store( new_block.id(), (*ritr)->data );
+                      _block_id_to_block.store( (*ritr)->id, (*ritr)->packed_data() );
                       session.commit();
                    }
                    throw *except;
@@ -192,14 +221,15 @@ bool database::_push_block(const signed_block& new_block)
       }
    }
 
+   const block_id_type new_block_id = new_block.id();
    try {
       auto session = _undo_db.start_undo_session();
       apply_block(new_block, skip);
-      _block_id_to_block.store(new_block.id(), new_block);
+      _block_id_to_block.store(new_block_id, new_block);
       session.commit();
    } catch ( const fc::exception& e ) {
       elog("Failed to push new block:\n${e}", ("e", e.to_detail_string()));
-      _fork_db.remove(new_block.id());
+      _fork_db.remove(new_block_id);
       throw;
    }
 
@@ -215,6 +245,48 @@ bool database::_push_block(const signed_block& new_block)
  * queues full as well, it will be kept in the queue to be propagated later when a new block flushes out the pending
  * queues.
  */
+namespace {
+   struct operation_fee_visitor
+   {
+      typedef asset result_type;
+      template<typename T>
+      asset operator()( const T& op )const { return op.fee; }
+   };
+
+   /**
+    * The fees declared by the transaction converted to the core asset at the core exchange rate, per 1024
+    * bytes of packed transaction.  Fees that can't be converted count as nothing.
+    */
+   uint64_t pending_fee_per_kbyte( const database& db, const signed_transaction& trx, uint32_t packed_size )
+   {
+      fc::uint128 total = 0;
+      for( const operation& op : trx.operations )
+      {
+         asset fee = op.visit( operation_fee_visitor() );
+         try
+         {
+            if( fee.asset_id != asset_id_type() )
+            {
+               const asset_object* a = db.find( fee.asset_id );
+               if( a == nullptr )
+                  continue;
+               fee = fee * a->options.core_exchange_rate;
+            }
+         }
+         catch( const fc::exception& )
+         {
+            continue;
+         }
+         if( fee.amount > 0 )
+            total += fee.amount.value;
+      }
+      total *= 1024;
+      total /= std::max<uint32_t>( packed_size, 1 );
+      return total > fc::uint128( std::numeric_limits<uint64_t>::max() ) ? std::numeric_limits<uint64_t>::max()
+                                                                         : total.to_uint64();
+   }
+}
+
 processed_transaction database::push_transaction( const signed_transaction& trx, uint32_t skip )
 { try {
    processed_transaction result;
@@ -227,10 +299,36 @@ processed_transaction database::push_transaction( const signed_transaction& trx,
 
 processed_transaction database::_push_transaction( const signed_transaction& trx )
 {
+   // When the pending pool is bounded, a transaction has to outbid what it would evict before it is applied.
+   const node_property_object& props = get_node_properties();
+   uint32_t packed_size = fc::raw::pack_size( trx );
+   uint64_t fee_rate = pending_fee_per_kbyte( *this, trx, packed_size );
+   GRAPHENE_ASSERT( _pending_tx.can_accept( packed_size, fee_rate, props.max_pending_transactions,
+                                            props.max_pending_transaction_bytes ),
+                    pending_transaction_pool_full,
+                    "pending transaction pool is full and the transaction does not pay a higher fee rate",
+                    ("fee_per_kbyte",fee_rate)("pending",_pending_tx.size()) );
+   if( _pending_tx.evict_for( packed_size, props.max_pending_transactions, props.max_pending_transaction_bytes ) > 0 )
+   {
+      // Apply the remaining transactions again, so that the evicted ones neither stay in the pending
+      // session nor in the list of known transactions.
+      detail::pending_transactions_restorer restorer( *this, std::move(_pending_tx) );
+   }
+
    // If this is the first transaction pushed after applying a block, start a new undo session.
    // This allows us to quickly rewind to the clean state of the head block, in case a new block arrives.
    if( !_pending_tx_session.valid() )
+   {
       _pending_tx_session = _undo_db.start_undo_session();
+      _pending_tx_ops.clear();
+      _pending_tx_in_session = 0;
+      _pending_tx_skip_flags = 0;
+   }
+
+   // Record the operations the way they appear if the next block is produced from the pending session.
+   _current_block_num = head_block_num() + 1;
+   _current_trx_in_block = _pending_tx_in_session;
+   size_t first_op = _applied_ops.size();
 
    // Create a temporary undo session as a child of _pending_tx_session.
    // The temporary session will be discarded by the destructor if
@@ -238,8 +336,20 @@ processed_transaction database::_push_transaction( const signed_transaction& trx
    // apply the changes.
 
    auto temp_session = _undo_db.start_undo_session();
-   auto processed_trx = _apply_transaction( trx );
-   _pending_tx.push_back(processed_trx);
+   processed_transaction processed_trx;
+   try {
+      processed_trx = _apply_transaction( trx );
+      _pending_tx.insert( processed_transaction( processed_trx ), packed_size, fee_rate );
+   } catch( const fc::exception& ) {
+      _applied_ops.resize( first_op );
+      throw;
+   }
+   _pending_tx_ops.insert( _pending_tx_ops.end(),
+                           std::make_move_iterator( _applied_ops.begin() + first_op ),
+                           std::make_move_iterator( _applied_ops.end() ) );
+   _applied_ops.resize( first_op );
+   ++_pending_tx_in_session;
+   _pending_tx_skip_flags |= get_node_properties().skip_flags;
 
    notify_changed_objects();
    // The transaction applied successfully. Merge its changes into the pending block session.
@@ -333,63 +443,97 @@ signed_block database::_generate_block(
    signed_block pending_block;
 
    //
-   // The following code throws away existing pending_tx_session and
-   // rebuilds it by re-applying pending transactions.
-   //
-   // This rebuild is necessary because pending transactions' validity
-   // and semantics may have changed since they were received, because
-   // time-based semantics are evaluated based on the current block
-   // time.  These changes can only be reflected in the database when
-   // the value of the "when" variable is known, which means we need to
-   // re-apply pending transactions in this method.
+   // Transactions are evaluated against the head block, so if every pending
+   // transaction has been applied on top of the current head in the pending
+   // session, with no more checks skipped than for this block, and they all
+   // fit, the pending session already holds their effects in block order.
+   // The block is then produced from it and only the block-level updates are
+   // applied when it is pushed.
    //
-   _pending_tx_session.reset();
-   _pending_tx_session = _undo_db.start_undo_session();
+   bool from_pending_state = get_node_properties().produce_from_pending_state
+      && _pending_tx_session.valid()
+      && _pending_tx_in_session == _pending_tx.size()
+      && _popped_tx.empty()
+      && !( _pending_tx_skip_flags & ~skip & ~skip_block_size_check )
+      && ( (skip & skip_fork_db) || !_fork_db.head() || _fork_db.head()->id == head_block_id() );
+   if( from_pending_state )
+   {
+      for( const pending_transaction& entry : _pending_tx.indices().get<by_sequence>() )
+         total_block_size += fc::raw::pack_size( entry.trx );
+      from_pending_state = total_block_size < maximum_block_size;
+   }
 
-   uint64_t postponed_tx_count = 0;
-   // pop pending state (reset to head block state)
-   for( const processed_transaction& tx : _pending_tx )
+   const auto& pending_in_order = _pending_tx.indices().get<by_sequence>();
+   if( from_pending_state )
+   {
+      pending_block.transactions.reserve( _pending_tx.size() );
+      for( const pending_transaction& entry : pending_in_order )
+         pending_block.transactions.push_back( entry.trx );
+   }
+   else
    {
-      size_t new_total_size = total_block_size + fc::raw::pack_size( tx );
+      total_block_size = max_block_header_size;
+
+      //
+      // The following code throws away existing pending_tx_session and
+      // rebuilds it by re-applying pending transactions.
+      //
+      // This rebuild is necessary because pending transactions' validity
+      // and semantics may have changed since they were received, because
+      // time-based semantics are evaluated based on the current block
+      // time.  These changes can only be reflected in the database when
+      // the value of the "when" variable is known, which means we need to
+      // re-apply pending transactions in this method.
+      //
+      _pending_tx_session.reset();
+      _pending_tx_session = _undo_db.start_undo_session();
 
-      // postpone transaction if it would make block too big
-      if( new_total_size >= maximum_block_size )
+      uint64_t postponed_tx_count = 0;
+      // pop pending state (reset to head block state)
+      for( const pending_transaction& entry : pending_in_order )
       {
-         postponed_tx_count++;
-         continue;
-      }
+         const processed_transaction& tx = entry.trx;
+         size_t new_total_size = total_block_size + fc::raw::pack_size( tx );
 
-      try
-      {
-         auto temp_session = _undo_db.start_undo_session();
-         processed_transaction ptx = _apply_transaction( tx );
-         temp_session.merge();
-
-         // We have to recompute pack_size(ptx) because it may be different
-         // than pack_size(tx) (i.e. if one or more results increased
-         // their size)
-         total_block_size += fc::raw::pack_size( ptx );
-         pending_block.transactions.push_back( ptx );
+         // postpone transaction if it would make block too big
+         if( new_total_size >= maximum_block_size )
+         {
+            postponed_tx_count++;
+            continue;
+         }
+
+         try
+         {
+            auto temp_session = _undo_db.start_undo_session();
+            processed_transaction ptx = _apply_transaction( tx );
+            temp_session.merge();
+
+            // We have to recompute pack_size(ptx) because it may be different
+            // than pack_size(tx) (i.e. if one or more results increased
+            // their size)
+            total_block_size += fc::raw::pack_size( ptx );
+            pending_block.transactions.push_back( ptx );
+         }
+         catch ( const fc::exception& e )
+         {
+            // Do nothing, transaction will not be re-applied
+            wlog( "Transaction was not processed while generating block due to ${e}", ("e", e) );
+            wlog( "The transaction was ${t}", ("t", tx) );
+         }
       }
-      catch ( const fc::exception& e )
+      if( postponed_tx_count > 0 )
       {
-         // Do nothing, transaction will not be re-applied
-         wlog( "Transaction was not processed while generating block due to ${e}", ("e", e) );
-         wlog( "The transaction was ${t}", ("t", tx) );
+         wlog( "Postponed ${n} transactions due to block size limit", ("n", postponed_tx_count) );
       }
-   }
-   if( postponed_tx_count > 0 )
-   {
-      wlog( "Postponed ${n} transactions due to block size limit", ("n", postponed_tx_count) );
-   }
 
-   _pending_tx_session.reset();
+      _pending_tx_session.reset();
 
-   // We have temporarily broken the invariant that
-   // _pending_tx_session is the result of applying _pending_tx, as
-   // _pending_tx now consists of the set of postponed transactions.
-   // However, the push_block() call below will re-create the
-   // _pending_tx_session.
+      // We have temporarily broken the invariant that
+      // _pending_tx_session is the result of applying _pending_tx, as
+      // _pending_tx now consists of the set of postponed transactions.
+      // However, the push_block() call below will re-create the
+      // _pending_tx_session.
+   }
 
    pending_block.previous = head_block_id();
    pending_block.timestamp = when;
@@ -421,11 +565,49 @@ signed_block database::_generate_block(
       FC_ASSERT( fc::raw::pack_size(pending_block) <= get_global_properties().parameters.maximum_block_size );
    }
 
-   push_block( pending_block, skip );
+   if( from_pending_state )
+   {
+      _push_block_from_pending_state( pending_block );
+      ++_blocks_from_pending_state;
+   }
+   else
+   {
+      push_block( pending_block, skip );
+      ++_blocks_by_reapplying;
+   }
 
    return pending_block;
 } FC_CAPTURE_AND_RETHROW( (witness_id) ) }
 
+/**
+ * Pushes a block produced by _generate_block() whose transactions are the
+ * pending transactions already applied in _pending_tx_session.  That session
+ * becomes the undo session of the block, so the transactions are not
+ * evaluated a second time.
+ */
+void database::_push_block_from_pending_state( const signed_block& new_block )
+{ try {
+   uint32_t skip = get_node_properties().skip_flags;
+   if( !(skip&skip_fork_db) )
+      _fork_db.push_block( new_block );
+
+   const block_id_type new_block_id = new_block.id();
+   try {
+      undo_database::session session = std::move( *_pending_tx_session );
+      _pending_tx_session.reset();
+      _apply_block( new_block, true );
+      _block_id_to_block.store( new_block_id, new_block );
+      session.commit();
+   } catch ( const fc::exception& e ) {
+      elog("Failed to push new block:\n${e}", ("e", e.to_detail_string()));
+      _fork_db.remove( new_block_id );
+      // the pending session has been undone, apply the pending transactions again
+      detail::pending_transactions_restorer restorer( *this, std::move(_pending_tx) );
+      throw;
+   }
+   _pending_tx.clear();
+} FC_CAPTURE_AND_RETHROW( (new_block) ) }
+
 /**
  * Removes the most recent block from the database and
  * undoes any changes it made.
@@ -500,7 +682,7 @@ void database::apply_block( const signed_block& next_block, uint32_t skip )
    return;
 }
 
-void database::_apply_block( const signed_block& next_block )
+void database::_apply_block( const signed_block& next_block, bool transactions_applied )
 { try {
    uint32_t next_block_num = next_block.block_num();
    uint32_t skip = get_node_properties().skip_flags;
@@ -516,16 +698,27 @@ void database::_apply_block( const signed_block& next_block )
    _current_block_num    = next_block_num;
    _current_trx_in_block = 0;
 
-   for( const auto& trx : next_block.transactions )
+   if( transactions_applied )
    {
-      /* We do not need to push the undo state for each transaction
-       * because they either all apply and are valid or the
-       * entire block fails to apply.  We only need an "undo" state
-       * for transactions when validating broadcast transactions or
-       * when building a block.
-       */
-      apply_transaction( trx, skip );
-      ++_current_trx_in_block;
+      // applied as pending transactions on top of the same head block, see _push_block_from_pending_state()
+      _applied_ops = std::move( _pending_tx_ops );
+      _pending_tx_ops.clear();
+      _current_trx_in_block = next_block.transactions.size();
+   }
+   else
+   {
+      verify_confidential_transactions( next_block );
+      for( const auto& trx : next_block.transactions )
+      {
+         /* We do not need to push the undo state for each transaction
+          * because they either all apply and are valid or the
+          * entire block fails to apply.  We only need an "undo" state
+          * for transactions when validating broadcast transactions or
+          * when building a block.
+          */
+         apply_transaction( trx, skip );
+         ++_current_trx_in_block;
+      }
    }
 
    if (global_props.parameters.witness_schedule_algorithm == GRAPHENE_WITNESS_SCHEDULED_ALGORITHM)
@@ -594,27 +787,90 @@ processed_transaction database::apply_transaction(const signed_transaction& trx,
    return result;
 }
 
+void database::verify_confidential_transactions( const signed_block& next_block )
+{
+   vector< const signed_transaction* > to_verify;
+   vector< transaction_id_type > ids;
+   for( const processed_transaction& trx : next_block.transactions )
+   {
+      bool confidential = std::any_of( trx.operations.begin(), trx.operations.end(), []( const operation& op ) {
+         return op.which() == operation::tag< transfer_to_blind_operation >::value
+             || op.which() == operation::tag< blind_transfer_operation >::value
+             || op.which() == operation::tag< transfer_from_blind_operation >::value;
+      });
+      if( !confidential )
+         continue;
+      transaction_id_type id = trx.id();
+      if( _validated_tx.contains( id ) )
+         continue;
+      to_verify.push_back( &trx );
+      ids.push_back( id );
+   }
+   // a single transaction is checked just as fast by _apply_transaction()
+   if( to_verify.size() < 2 )
+      return;
+
+   uint64_t thread_count = get_node_properties().confidential_verification_threads;
+   if( thread_count == 0 )
+      thread_count = std::thread::hardware_concurrency();
+   thread_count = std::max<uint64_t>( 1, std::min<uint64_t>( thread_count, to_verify.size() ) );
+
+   // failures are not reported from here, the transaction is simply checked again when it is applied
+   vector< char > valid( to_verify.size(), 0 );
+   auto verify_range = [&]( uint64_t t ) {
+      for( size_t i = t; i < to_verify.size(); i += thread_count )
+      {
+         try {
+            to_verify[i]->validate();
+            valid[i] = 1;
+         } catch( ... ) {
+         }
+      }
+   };
+
+   vector< std::thread > threads;
+   for( uint64_t t = 1; t < thread_count; ++t )
+      threads.emplace_back( verify_range, t );
+   verify_range( 0 );
+   for( std::thread& thread : threads )
+      thread.join();
+
+   for( size_t i = 0; i < to_verify.size(); ++i )
+      if( valid[i] )
+         _validated_tx.record( ids[i], to_verify[i]->expiration );
+}
+
 processed_transaction database::_apply_transaction(const signed_transaction& trx)
 { try {
    uint32_t skip = get_node_properties().skip_flags;
+   const bool check_signatures = !(skip & (skip_transaction_signatures | skip_authority_check));
+   transaction_id_type trx_id;
+   digest_type sig_digest;
+   if( check_signatures )
+   {
+      // pack the transaction once for both its id and the digest its signatures sign
+      const vector<char>& packed_trx = graphene::db::pack_to_buffer( static_cast<const transaction&>( trx ) );
+      trx_id = transaction::id_from_packed( packed_trx );
+      sig_digest = transaction::sig_digest_from_packed( get_chain_id(), packed_trx );
+   }
+   else
+      trx_id = trx.id();
+   _touched_balances.clear();
 
    if( true || !(skip&skip_validate) )   /* issue #505 explains why this skip_flag is disabled */
-      trx.validate();
+      _validated_tx.validate( trx, trx_id );
 
    auto& trx_idx = get_mutable_index_type<transaction_index>();
-   const chain_id_type& chain_id = get_chain_id();
-   auto trx_id = trx.id();
    FC_ASSERT( (skip & skip_transaction_dupe_check) ||
               trx_idx.indices().get<by_trx_id>().find(trx_id) == trx_idx.indices().get<by_trx_id>().end() );
    transaction_evaluation_state eval_state(this);
    const chain_parameters& chain_parameters = get_global_properties().parameters;
    eval_state._trx = &trx;
 
-   if( !(skip & (skip_transaction_signatures | skip_authority_check) ) )
+   if( check_signatures )
    {
-      auto get_active = [&]( account_id_type id ) { return &id(*this).active; };
-      auto get_owner  = [&]( account_id_type id ) { return &id(*this).owner;  };
-      trx.verify_authority( chain_id, get_active, get_owner, get_global_properties().parameters.max_authority_depth );
+      _authority_resolver.verify_authority( *this, trx, trx.get_signature_keys_from_digest( sig_digest ),
+                                            get_global_properties().parameters.max_authority_depth );
    }
 
    //Skip all manner of expiration and TaPoS checking if we're on block 1; It's impossible that the transaction is
@@ -641,7 +897,9 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
    {
       create<transaction_object>([&](transaction_object& transaction) {
          transaction.trx_id = trx_id;
-         transaction.trx = trx;
+         transaction.expiration = trx.expiration;
+         transaction.block_num = _current_block_num;
+         transaction.trx_in_block = _current_trx_in_block;
       });
    }
 
@@ -656,6 +914,8 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
       ++_current_op_in_trx;
    }
    ptrx.operation_results = std::move(eval_state.operation_results);
+   _evaluation_cache_stats.lookups += eval_state.cache_stats.lookups;
+   _evaluation_cache_stats.hits += eval_state.cache_stats.hits;
 
    //Make sure the temp account has no non-zero balances
    const auto& index = get_index_type<account_balance_index>().indices().get<by_account_asset>();
@@ -711,8 +971,9 @@ const witness_object& database::validate_block_header( uint32_t skip, const sign
 void database::create_block_summary(const signed_block& next_block)
 {
    block_summary_id_type sid(next_block.block_num() & 0xffff );
+   // update_global_dynamic_data() already computed the id of the block
    modify( sid(*this), [&](block_summary_object& p) {
-         p.block_id = next_block.id();
+         p.block_id = head_block_id();
    });
 }
 
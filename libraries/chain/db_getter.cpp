@@ -92,6 +92,26 @@ node_property_object& database::node_properties()
    return _node_property_object;
 }
 
+const validated_transaction_cache& database::get_validated_transactions()const
+{
+   return _validated_tx;
+}
+
+const evaluation_cache_stats& database::get_evaluation_cache_stats()const
+{
+   return _evaluation_cache_stats;
+}
+
+proposal_authorization_cache& database::get_proposal_authorizations()
+{
+   return _proposal_authorizations;
+}
+
+authority_resolver& database::get_authority_resolver()
+{
+   return _authority_resolver;
+}
+
 uint32_t database::last_non_undoable_block_num() const
 {
    return head_block_num() - _undo_db.size();
@@ -185,15 +185,21 @@ void database::initialize_evaluators()
 void database::initialize_indexes()
 {
    reset_indexes();
+   _vote_tally_tracker.reset();
+   _proposal_authorizations.clear();
+   _authority_resolver.clear();
    _undo_db.set_max_size( GRAPHENE_MIN_UNDO_HISTORY );
 
    //Protocol object indexes
-   add_index< primary_index<asset_index> >();
+   auto asset_idx = add_index< primary_index<asset_index> >();
+   asset_idx->add_secondary_index<market_issued_asset_change_index>();
    add_index< primary_index<force_settlement_index> >();
 
    auto acnt_index = add_index< primary_index<account_index> >();
    acnt_index->add_secondary_index<account_member_index>();
    acnt_index->add_secondary_index<account_referrer_index>();
+   acnt_index->add_secondary_index<proposal_authorization_index>( _proposal_authorizations );
+   acnt_index->add_secondary_index<authority_resolver_index>( _authority_resolver );
 
    add_index< primary_index<committee_member_index> >();
    add_index< primary_index<witness_index> >();
@@ -202,6 +208,7 @@ void database::initialize_indexes()
 
    auto prop_index = add_index< primary_index<proposal_index > >();
    prop_index->add_secondary_index<required_approval_index>();
+   prop_index->add_secondary_index<proposal_authorization_index>( _proposal_authorizations );
 
    add_index< primary_index<withdraw_permission_index > >();
    add_index< primary_index<vesting_balance_index> >();
@@ -212,13 +219,15 @@ void database::initialize_indexes()
    add_index< primary_index<tournament_index> >();
    auto tournament_details_idx = add_index< primary_index<tournament_details_index> >();
    tournament_details_idx->add_secondary_index<tournament_players_index>();
-   add_index< primary_index<match_index> >();
+   auto match_idx = add_index< primary_index<match_index> >();
+   match_idx->add_secondary_index<tournament_match_change_index>();
    add_index< primary_index<game_index> >();
 
    //Implementation object indexes
    add_index< primary_index<transaction_index                             > >();
    add_index< primary_index<account_balance_index                         > >();
-   add_index< primary_index<asset_bitasset_data_index                     > >();
+   auto bitasset_idx = add_index< primary_index<asset_bitasset_data_index > >();
+   bitasset_idx->add_secondary_index<bitasset_feed_expiration_index>();
    add_index< primary_index<asset_dividend_data_object_index              > >();
    add_index< primary_index<simple_index<global_property_object          >> >();
    add_index< primary_index<simple_index<dynamic_global_property_object  >> >();
@@ -258,6 +267,21 @@ void database::init_genesis(const genesis_state_type& genesis_state)
    } inhibitor(*this);
 
    transaction_evaluation_state genesis_eval_state(this);
+   // Nothing ever observes the operations applied by genesis, so don't let one history entry per
+   // initial account pile up in _applied_ops until the first block clears it.
+   auto apply_genesis_operation = [&]( const operation& op ) {
+      operation_result result = apply_operation( genesis_eval_state, op );
+      _applied_ops.clear();
+      return result;
+   };
+
+   // The account secondary indexes are built once from the final accounts below instead of being
+   // updated for every create and authority change of every initial account.
+   auto& account_primary_index = get_mutable_index_type< primary_index<account_index> >();
+   account_primary_index.defer_secondary_indexes();
+   get_mutable_index_type< simple_index<account_statistics_object> >().reserve(
+      genesis_state.immutable_parameters.num_special_accounts
+      + genesis_state.initial_bts_accounts.size() + genesis_state.initial_accounts.size() );
 
    flat_index<block_summary_object>& bsi = get_mutable_index_type< flat_index<block_summary_object> >();
    bsi.resize(0xffff+1);
@@ -488,7 +512,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
       cop.name = account.name;
       cop.registrar = GRAPHENE_TEMP_ACCOUNT;
       cop.owner = authority(1, GRAPHENE_TEMP_ACCOUNT, 1);
-      account_id_type account_id(apply_operation(genesis_eval_state, cop).get<object_id_type>());
+      account_id_type account_id(apply_genesis_operation(cop).get<object_id_type>());
    }
 
    // Create initial accounts
@@ -508,19 +532,19 @@ void database::init_genesis(const genesis_state_type& genesis_state)
          cop.active = authority(1, account.active_key, 1);
          cop.options.memo_key = account.active_key;
       }
-      account_id_type account_id(apply_operation(genesis_eval_state, cop).get<object_id_type>());
+      account_id_type account_id(apply_genesis_operation(cop).get<object_id_type>());
 
       if( account.is_lifetime_member )
       {
           account_upgrade_operation op;
           op.account_to_upgrade = account_id;
           op.upgrade_to_lifetime_member = true;
-          apply_operation(genesis_eval_state, op);
+          apply_genesis_operation(op);
       }
    }
 
    // Helper function to get account ID by name
-   const auto& accounts_by_name = get_index_type<account_index>().indices().get<by_name>();
+   const auto& accounts_by_name = get_index_type<account_index>().indices().get<by_name_hash>();
    auto get_account_id = [&accounts_by_name](const string& name) {
       auto itr = accounts_by_name.find(name);
       FC_ASSERT(itr != accounts_by_name.end(),
@@ -552,7 +576,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
       
       op.active = std::move(active_authority);
 
-      apply_operation(genesis_eval_state, op);
+      apply_genesis_operation(op);
    }
 
    // Helper function to get asset ID by symbol
@@ -593,7 +617,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
             cop.registrar = GRAPHENE_TEMP_ACCOUNT;
             cop.owner = authority(1, collateral_rec.owner, 1);
             cop.active = cop.owner;
-            account_id_type owner_account_id = apply_operation(genesis_eval_state, cop).get<object_id_type>();
+            account_id_type owner_account_id = apply_genesis_operation(cop).get<object_id_type>();
 
             modify( owner_account_id(*this).statistics(*this), [&]( account_statistics_object& o ) {
                     o.total_core_in_orders = collateral_rec.collateral;
@@ -614,6 +638,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
          }
 
          bitasset_data_id = create<asset_bitasset_data_object>([&](asset_bitasset_data_object& b) {
+            b.asset_id = new_asset_id;
             b.options.short_backing_asset = core_asset.id;
             b.options.minimum_feeds = GRAPHENE_DEFAULT_MINIMUM_FEEDS;
          }).id;
@@ -784,7 +809,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
       op.initial_secret = secret_hash_type::hash(secret_hash_type());
       op.witness_account = get_account_id(witness.owner_name);
       op.block_signing_key = witness.block_signing_key;
-      apply_operation(genesis_eval_state, op);
+      apply_genesis_operation(op);
    });
 
    // Create initial committee members
@@ -792,7 +817,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
                  [&](const genesis_state_type::initial_committee_member_type& member) {
       committee_member_create_operation op;
       op.committee_member_account = get_account_id(member.owner_name);
-      apply_operation(genesis_eval_state, op);
+      apply_genesis_operation(op);
    });
 
    // Create initial workers
@@ -807,7 +832,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
        op.name = "Genesis-Worker-" + worker.owner_name;
        op.initializer = vesting_balance_worker_initializer{uint16_t(0)};
 
-       apply_operation(genesis_eval_state, std::move(op));
+       apply_genesis_operation(std::move(op));
    });
 
    // Set active witnesses
@@ -890,6 +915,8 @@ void database::init_genesis(const genesis_state_type& genesis_state)
 
    FC_ASSERT( get_index<fba_accumulator_object>().get_next_id() == fba_accumulator_id_type( fba_accumulator_id_count ) );
 
+   account_primary_index.rebuild_secondary_indexes();
+
    debug_dump();
 
    _undo_db.enable();
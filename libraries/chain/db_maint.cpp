@@ -48,6 +48,9 @@
 #include <graphene/chain/witness_schedule_object.hpp>
 #include <graphene/chain/worker_object.hpp>
 
+#include <exception>
+#include <thread>
+
 namespace graphene { namespace chain {
 
 template<class Index>
@@ -115,6 +118,28 @@ void database::update_worker_votes()
    }
 }
 
+void database::init_vote_tally_tracker()
+{
+   if( !_vote_tally_tracker )
+   {
+      _vote_tally_tracker.reset( new vote_tally_tracker( *this ) );
+      get_mutable_index_type< primary_index<account_index> >().add_secondary_index<vote_tally_index>( *_vote_tally_tracker );
+      get_mutable_index_type< primary_index<account_balance_index> >().add_secondary_index<vote_tally_index>( *_vote_tally_tracker );
+      get_mutable_index_type< primary_index<vesting_balance_index> >().add_secondary_index<vote_tally_index>( *_vote_tally_tracker );
+      get_mutable_index_type< primary_index<simple_index<account_statistics_object>> >()
+            .add_secondary_index<vote_tally_index>( *_vote_tally_tracker );
+   }
+
+   // accounts look up their cashback balance when they are counted, so vesting balances go first
+   vote_tally_tracker& tracker = *_vote_tally_tracker;
+   tracker.clear();
+   auto count_object = [&tracker]( const object& o ) { tracker.object_inserted( o ); };
+   get_index_type<vesting_balance_index>().inspect_all_objects( count_object );
+   get_index_type<account_balance_index>().inspect_all_objects( count_object );
+   get_index_type<simple_index<account_statistics_object>>().inspect_all_objects( count_object );
+   get_index_type<account_index>().inspect_all_objects( count_object );
+}
+
 void database::pay_workers( share_type& budget )
 {
 //   ilog("Processing payroll! Available budget is ${b}", ("b", budget));
@@ -752,25 +777,56 @@ void schedule_pending_dividend_balances(database& db,
       balance_index.indices().get<by_asset_balance>().lower_bound(boost::make_tuple(dividend_holder_asset_obj.id));
    auto holder_balances_end =
       balance_index.indices().get<by_asset_balance>().upper_bound(boost::make_tuple(dividend_holder_asset_obj.id, share_type()));
-   uint32_t holder_account_count = std::distance(holder_balances_begin, holder_balances_end);
    uint64_t distribution_base_fee = gpo.parameters.current_fees->get<asset_dividend_distribution_operation>().distribution_base_fee;
    uint32_t distribution_fee_per_holder = gpo.parameters.current_fees->get<asset_dividend_distribution_operation>().distribution_fee_per_holder;
+
+   // Most maintenance intervals nothing is deposited into the distribution account, so the holders are only
+   // visited once the balance of a payout asset has changed, and at most once per dividend asset.
+   optional<uint32_t> holder_account_count;
    // the fee, in BTS, for distributing each asset in the account
-   uint64_t total_fee_per_asset_in_core = distribution_base_fee + holder_account_count * (uint64_t)distribution_fee_per_holder;
-
-   std::map<account_id_type, share_type> vesting_amounts;
-   // get only once a collection of accounts that hold nonzero vesting balances of the dividend asset
-   auto vesting_balances_begin =
-      vesting_index.indices().get<by_asset_balance>().lower_bound(boost::make_tuple(dividend_holder_asset_obj.id));
-   auto vesting_balances_end =
-      vesting_index.indices().get<by_asset_balance>().upper_bound(boost::make_tuple(dividend_holder_asset_obj.id, share_type()));
-   for (const vesting_balance_object& vesting_balance_obj : boost::make_iterator_range(vesting_balances_begin, vesting_balances_end))
-   {
-        vesting_amounts[vesting_balance_obj.owner] += vesting_balance_obj.balance.amount;
-        //dlog("Vesting balance for account: ${owner}, amount: ${amount}",
-        //     ("owner", vesting_balance_obj.owner(db).name)
-        //     ("amount", vesting_balance_obj.balance.amount));
-   }
+   auto get_total_fee_per_asset_in_core = [&]() {
+      if (!holder_account_count)
+         holder_account_count = std::distance(holder_balances_begin, holder_balances_end);
+      return distribution_base_fee + *holder_account_count * (uint64_t)distribution_fee_per_holder;
+   };
+
+   // when we pay out the dividends to the holders, we need to know the total balance of the dividend asset in all
+   // accounts other than the distribution account (it would be silly to distribute dividends back to 
+   // the distribution account)
+   share_type total_balance_of_dividend_asset;
+   // the balance of each holder including its vesting balances, in the order holders are credited
+   vector<std::pair<account_id_type, share_type>> holder_balances;
+   bool holder_balances_computed = false;
+   auto compute_holder_balances = [&]() {
+      if (holder_balances_computed)
+         return;
+      holder_balances_computed = true;
+
+      // collect the vesting balances of the dividend asset once, summed up per owner
+      vector<std::pair<account_id_type, share_type>> vesting_amounts;
+      auto vesting_balances_begin =
+         vesting_index.indices().get<by_asset_balance>().lower_bound(boost::make_tuple(dividend_holder_asset_obj.id));
+      auto vesting_balances_end =
+         vesting_index.indices().get<by_asset_balance>().upper_bound(boost::make_tuple(dividend_holder_asset_obj.id, share_type()));
+      for (const vesting_balance_object& vesting_balance_obj : boost::make_iterator_range(vesting_balances_begin, vesting_balances_end))
+         vesting_amounts.emplace_back(vesting_balance_obj.owner, vesting_balance_obj.balance.amount);
+      std::sort(vesting_amounts.begin(), vesting_amounts.end());
+      auto vesting_amount = [&](account_id_type owner) {
+         share_type amount;
+         for (auto itr = std::lower_bound(vesting_amounts.begin(), vesting_amounts.end(), std::make_pair(owner, share_type()));
+              itr != vesting_amounts.end() && itr->first == owner; ++itr)
+            amount += itr->second;
+         return amount;
+      };
+
+      for (const account_balance_object& holder_balance_object : boost::make_iterator_range(holder_balances_begin, holder_balances_end))
+         if (holder_balance_object.owner != dividend_data.dividend_distribution_account)
+         {
+            share_type holder_balance = holder_balance_object.balance + vesting_amount(holder_balance_object.owner);
+            holder_balances.emplace_back(holder_balance_object.owner, holder_balance);
+            total_balance_of_dividend_asset += holder_balance;
+         }
+   };
 
    auto current_distribution_account_balance_iter = current_distribution_account_balance_range.first;
    auto previous_distribution_account_balance_iter = previous_distribution_account_balance_range.first;
@@ -778,18 +834,6 @@ void schedule_pending_dividend_balances(database& db,
         ("current", std::distance(current_distribution_account_balance_range.first, current_distribution_account_balance_range.second))
         ("previous", std::distance(previous_distribution_account_balance_range.first, previous_distribution_account_balance_range.second)));
 
-   // when we pay out the dividends to the holders, we need to know the total balance of the dividend asset in all
-   // accounts other than the distribution account (it would be silly to distribute dividends back to 
-   // the distribution account)
-   share_type total_balance_of_dividend_asset;
-   for (const account_balance_object& holder_balance_object : boost::make_iterator_range(holder_balances_begin, holder_balances_end))
-      if (holder_balance_object.owner != dividend_data.dividend_distribution_account)
-      {
-         total_balance_of_dividend_asset += holder_balance_object.balance;
-         auto itr = vesting_amounts.find(holder_balance_object.owner);
-         if (itr != vesting_amounts.end())
-             total_balance_of_dividend_asset += itr->second;
-      }
    // loop through all of the assets currently or previously held in the distribution account
    while (current_distribution_account_balance_iter != current_distribution_account_balance_range.second ||
           previous_distribution_account_balance_iter != previous_distribution_account_balance_range.second)
@@ -827,6 +871,8 @@ void schedule_pending_dividend_balances(database& db,
          }
 
          share_type delta_balance = current_balance - previous_balance;
+         // nothing is deposited or withdrawn in most intervals, don't count the holders for a fee that isn't charged
+         const uint64_t total_fee_per_asset_in_core = delta_balance == 0 ? 0 : get_total_fee_per_asset_in_core();
 
          // Next, figure out if we want to share this out -- if the amount added to the distribution 
          // account since last payout is too small, we won't bother.
@@ -908,21 +954,17 @@ void schedule_pending_dividend_balances(database& db,
                   delta_balance -= total_fee_per_asset_in_payout_asset;
                }
 
+               compute_holder_balances();
                dlog("There are ${count} holders of the dividend-paying asset, with a total balance of ${total}", 
                     ("count", holder_account_count)
                     ("total", total_balance_of_dividend_asset));
                share_type remaining_amount_to_distribute = delta_balance;
 
-               // credit each account with their portion, don't send any back to the dividend distribution account
-               for (const account_balance_object& holder_balance_object : boost::make_iterator_range(holder_balances_begin, holder_balances_end))
+               // credit each account with their portion, the dividend distribution account is not among the holders
+               for (const auto& holder : holder_balances)
                {
-                  if (holder_balance_object.owner == dividend_data.dividend_distribution_account) continue;
-
-                  auto holder_balance = holder_balance_object.balance;
-
-                  auto itr = vesting_amounts.find(holder_balance_object.owner);
-                  if (itr != vesting_amounts.end())
-                      holder_balance += itr->second;
+                  const account_id_type& holder_account = holder.first;
+                  const share_type& holder_balance = holder.second;
 
                   fc::uint128_t amount_to_credit(delta_balance.value);
                   amount_to_credit *= holder_balance.value;
@@ -930,18 +972,16 @@ void schedule_pending_dividend_balances(database& db,
                   share_type shares_to_credit((int64_t)amount_to_credit.to_uint64());
                   if (shares_to_credit.value)
                   {
-                     wdump((delta_balance.value)(holder_balance)(total_balance_of_dividend_asset));
-
                      remaining_amount_to_distribute -= shares_to_credit;
 
                      dlog("Crediting account ${account} with ${amount}", 
-                          ("account", holder_balance_object.owner(db).name)
+                          ("account", holder_account(db).name)
                           ("amount", asset(shares_to_credit, payout_asset_type)));
                      auto pending_payout_iter = 
-                        pending_payout_balance_index.indices().get<by_dividend_payout_account>().find(boost::make_tuple(dividend_holder_asset_obj.id, payout_asset_type, holder_balance_object.owner));
+                        pending_payout_balance_index.indices().get<by_dividend_payout_account>().find(boost::make_tuple(dividend_holder_asset_obj.id, payout_asset_type, holder_account));
                      if (pending_payout_iter == pending_payout_balance_index.indices().get<by_dividend_payout_account>().end())
                         db.create<pending_dividend_payout_balance_for_holder_object>( [&]( pending_dividend_payout_balance_for_holder_object& obj ){
-                           obj.owner = holder_balance_object.owner;
+                           obj.owner = holder_account;
                            obj.dividend_holder_asset_type = dividend_holder_asset_obj.id;
                            obj.dividend_payout_asset_type = payout_asset_type;
                            obj.pending_balance = shares_to_credit;
@@ -953,11 +993,6 @@ void schedule_pending_dividend_balances(database& db,
                   }
                }
 
-               for (const auto& pending_payout : pending_payout_balance_index.indices())
-                  if (pending_payout.pending_balance.value)
-                      dlog("Pending payout: ${account_name}   ->   ${amount}",
-                           ("account_name", pending_payout.owner(db).name)
-                           ("amount", asset(pending_payout.pending_balance, pending_payout.dividend_payout_asset_type)));
                dlog("Remaining balance not paid out: ${amount}", 
                     ("amount", asset(remaining_amount_to_distribute, payout_asset_type)));
 
@@ -1053,153 +1088,153 @@ void process_dividend_assets(database& db)
    const total_distributed_dividend_balance_object_index& distributed_dividend_balance_index = db.get_index_type<total_distributed_dividend_balance_object_index>();
    const pending_dividend_payout_balance_for_holder_object_index& pending_payout_balance_index = db.get_index_type<pending_dividend_payout_balance_for_holder_object_index>();
 
-   // TODO: switch to iterating over only dividend assets (generalize the by_type index)
-   for( const asset_object& dividend_holder_asset_obj : db.get_index_type<asset_index>().indices() )
-      if (dividend_holder_asset_obj.dividend_data_id)
-      {
-         const asset_dividend_data_object& dividend_data = dividend_holder_asset_obj.dividend_data(db);
-         const account_object& dividend_distribution_account_object = dividend_data.dividend_distribution_account(db);
+   // the holder assets are visited in id order, like all assets were before
+   auto dividend_holder_assets = db.get_index_type<asset_index>().indices().get<by_dividend_holder>().equal_range(boost::make_tuple(true));
+   for( const asset_object& dividend_holder_asset_obj : boost::make_iterator_range(dividend_holder_assets.first, dividend_holder_assets.second) )
+   {
+      const asset_dividend_data_object& dividend_data = dividend_holder_asset_obj.dividend_data(db);
+      const account_object& dividend_distribution_account_object = dividend_data.dividend_distribution_account(db);
 
-         fc::time_point_sec current_head_block_time = db.head_block_time();
+      fc::time_point_sec current_head_block_time = db.head_block_time();
 
-         schedule_pending_dividend_balances(db, dividend_holder_asset_obj, dividend_data, current_head_block_time,
-                                            balance_index, vbalance_index, distributed_dividend_balance_index, pending_payout_balance_index);
-         if (dividend_data.options.next_payout_time &&
-             db.head_block_time() >= *dividend_data.options.next_payout_time)
-         {
-            dlog("Dividend payout time has arrived for asset ${holder_asset}", 
-                 ("holder_asset", dividend_holder_asset_obj.symbol));
+      schedule_pending_dividend_balances(db, dividend_holder_asset_obj, dividend_data, current_head_block_time,
+                                         balance_index, vbalance_index, distributed_dividend_balance_index, pending_payout_balance_index);
+      if (dividend_data.options.next_payout_time &&
+          db.head_block_time() >= *dividend_data.options.next_payout_time)
+      {
+         dlog("Dividend payout time has arrived for asset ${holder_asset}", 
+              ("holder_asset", dividend_holder_asset_obj.symbol));
 
 #ifndef NDEBUG
-            // dump balances before the payouts for debugging
-            const auto& balance_idx = db.get_index_type<account_balance_index>().indices().get<by_account_asset>();
-            auto holder_account_balance_range = balance_idx.equal_range(boost::make_tuple(dividend_data.dividend_distribution_account));
-            for (const account_balance_object& holder_balance_object : boost::make_iterator_range(holder_account_balance_range.first, holder_account_balance_range.second))
-               ilog("  Current balance: ${asset}", ("asset", asset(holder_balance_object.balance, holder_balance_object.asset_type)));
+         // dump balances before the payouts for debugging
+         const auto& balance_idx = db.get_index_type<account_balance_index>().indices().get<by_account_asset>();
+         auto holder_account_balance_range = balance_idx.equal_range(boost::make_tuple(dividend_data.dividend_distribution_account));
+         for (const account_balance_object& holder_balance_object : boost::make_iterator_range(holder_account_balance_range.first, holder_account_balance_range.second))
+            ilog("  Current balance: ${asset}", ("asset", asset(holder_balance_object.balance, holder_balance_object.asset_type)));
 #endif
 
-            // when we do the payouts, we first increase the balances in all of the receiving accounts
-            // and use this map to keep track of the total amount of each asset paid out.
-            // Afterwards, we decrease the distribution account's balance by the total amount paid out, 
-            // and modify the distributed_balances accordingly
-            std::map<asset_id_type, share_type> amounts_paid_out_by_asset;
-
-            auto pending_payouts_range = 
-               pending_payout_balance_index.indices().get<by_dividend_account_payout>().equal_range(boost::make_tuple(dividend_holder_asset_obj.id));
-            // the pending_payouts_range is all payouts for this dividend asset, sorted by the holder's account
-            // we iterate in this order so we can build up a list of payouts for each account to put in the 
-            // virtual op
-            flat_set<asset> payouts_for_this_holder;
-            fc::optional<account_id_type> last_holder_account_id;
-
-            // cache the assets the distribution account is approved to send, we will be asking
-            // for these often
-            flat_map<asset_id_type, bool> approved_assets; // assets that the dividend distribution account is authorized to send/receive
-            auto is_asset_approved_for_distribution_account = [&](const asset_id_type& asset_id) {
-               auto approved_assets_iter = approved_assets.find(asset_id);
-               if (approved_assets_iter != approved_assets.end())
-                  return approved_assets_iter->second;
-               bool is_approved = is_authorized_asset(db, dividend_distribution_account_object, 
-                                                      asset_id(db));
-               approved_assets[asset_id] = is_approved;
-               return is_approved;
-            };
-
-            for (auto pending_balance_object_iter = pending_payouts_range.first; pending_balance_object_iter != pending_payouts_range.second; )
-            {
-               const pending_dividend_payout_balance_for_holder_object& pending_balance_object = *pending_balance_object_iter;
-
-               if (last_holder_account_id && *last_holder_account_id != pending_balance_object.owner && payouts_for_this_holder.size())
-               {
-                  // we've moved on to a new account, generate the dividend payment virtual op for the previous one
-                  db.push_applied_operation(asset_dividend_distribution_operation(dividend_holder_asset_obj.id, 
-                                                                                  *last_holder_account_id, 
-                                                                                  payouts_for_this_holder));
-                  dlog("Just pushed virtual op for payout to ${account}", ("account", (*last_holder_account_id)(db).name));
-                  payouts_for_this_holder.clear();
-                  last_holder_account_id.reset();
-               }
-
-
-               if (pending_balance_object.pending_balance.value &&
-                   is_authorized_asset(db, pending_balance_object.owner(db), pending_balance_object.dividend_payout_asset_type(db)) &&
-                   is_asset_approved_for_distribution_account(pending_balance_object.dividend_payout_asset_type))
-               {
-                  dlog("Processing payout of ${asset} to account ${account}", 
-                       ("asset", asset(pending_balance_object.pending_balance, pending_balance_object.dividend_payout_asset_type))
-                       ("account", pending_balance_object.owner(db).name));
-
-                  db.adjust_balance(pending_balance_object.owner,
-                                    asset(pending_balance_object.pending_balance, 
-                                          pending_balance_object.dividend_payout_asset_type));
-                  payouts_for_this_holder.insert(asset(pending_balance_object.pending_balance, 
-                                                       pending_balance_object.dividend_payout_asset_type));
-                  last_holder_account_id = pending_balance_object.owner;
-                  amounts_paid_out_by_asset[pending_balance_object.dividend_payout_asset_type] += pending_balance_object.pending_balance;
-
-                  db.modify(pending_balance_object, [&]( pending_dividend_payout_balance_for_holder_object& pending_balance ){
-                     pending_balance.pending_balance = 0;
-                  });
-               }
+         // when we do the payouts, we first increase the balances in all of the receiving accounts
+         // and use this map to keep track of the total amount of each asset paid out.
+         // Afterwards, we decrease the distribution account's balance by the total amount paid out, 
+         // and modify the distributed_balances accordingly
+         std::map<asset_id_type, share_type> amounts_paid_out_by_asset;
+
+         auto pending_payouts_range = 
+            pending_payout_balance_index.indices().get<by_dividend_account_payout>().equal_range(boost::make_tuple(dividend_holder_asset_obj.id));
+         // the pending_payouts_range is all payouts for this dividend asset, sorted by the holder's account
+         // we iterate in this order so we can build up a list of payouts for each account to put in the 
+         // virtual op
+         flat_set<asset> payouts_for_this_holder;
+         fc::optional<account_id_type> last_holder_account_id;
+
+         // cache the assets the distribution account is approved to send, we will be asking
+         // for these often
+         flat_map<asset_id_type, bool> approved_assets; // assets that the dividend distribution account is authorized to send/receive
+         auto is_asset_approved_for_distribution_account = [&](const asset_id_type& asset_id) {
+            auto approved_assets_iter = approved_assets.find(asset_id);
+            if (approved_assets_iter != approved_assets.end())
+               return approved_assets_iter->second;
+            bool is_approved = is_authorized_asset(db, dividend_distribution_account_object, 
+                                                   asset_id(db));
+            approved_assets[asset_id] = is_approved;
+            return is_approved;
+         };
+
+         for (auto pending_balance_object_iter = pending_payouts_range.first; pending_balance_object_iter != pending_payouts_range.second; )
+         {
+            const pending_dividend_payout_balance_for_holder_object& pending_balance_object = *pending_balance_object_iter;
 
-               ++pending_balance_object_iter;
-            }
-            // we will always be left with the last holder's data, generate the virtual op for it now.
-            if (last_holder_account_id && payouts_for_this_holder.size())
+            if (last_holder_account_id && *last_holder_account_id != pending_balance_object.owner && payouts_for_this_holder.size())
             {
                // we've moved on to a new account, generate the dividend payment virtual op for the previous one
                db.push_applied_operation(asset_dividend_distribution_operation(dividend_holder_asset_obj.id, 
                                                                                *last_holder_account_id, 
                                                                                payouts_for_this_holder));
                dlog("Just pushed virtual op for payout to ${account}", ("account", (*last_holder_account_id)(db).name));
+               payouts_for_this_holder.clear();
+               last_holder_account_id.reset();
             }
 
-            // now debit the total amount of dividends paid out from the distribution account
-            // and reduce the distributed_balances accordingly
 
-            for (const auto& value : amounts_paid_out_by_asset)
+            if (pending_balance_object.pending_balance.value &&
+                is_authorized_asset(db, pending_balance_object.owner(db), pending_balance_object.dividend_payout_asset_type(db)) &&
+                is_asset_approved_for_distribution_account(pending_balance_object.dividend_payout_asset_type))
             {
-               const asset_id_type& asset_paid_out = value.first;
-               const share_type& amount_paid_out = value.second;
-
-               db.adjust_balance(dividend_data.dividend_distribution_account, 
-                                 asset(-amount_paid_out,
-                                       asset_paid_out));
-               auto distributed_balance_iter = 
-                  distributed_dividend_balance_index.indices().get<by_dividend_payout_asset>().find(boost::make_tuple(dividend_holder_asset_obj.id, 
-                                                                                                                      asset_paid_out));
-               assert(distributed_balance_iter != distributed_dividend_balance_index.indices().get<by_dividend_payout_asset>().end());
-               if (distributed_balance_iter != distributed_dividend_balance_index.indices().get<by_dividend_payout_asset>().end())
-                  db.modify(*distributed_balance_iter, [&]( total_distributed_dividend_balance_object& obj ){
-                     obj.balance_at_last_maintenance_interval -= amount_paid_out; // now they've been paid out, reset to zero
-                  });
+               dlog("Processing payout of ${asset} to account ${account}", 
+                    ("asset", asset(pending_balance_object.pending_balance, pending_balance_object.dividend_payout_asset_type))
+                    ("account", pending_balance_object.owner(db).name));
+
+               db.adjust_balance(pending_balance_object.owner,
+                                 asset(pending_balance_object.pending_balance, 
+                                       pending_balance_object.dividend_payout_asset_type));
+               payouts_for_this_holder.insert(asset(pending_balance_object.pending_balance, 
+                                                    pending_balance_object.dividend_payout_asset_type));
+               last_holder_account_id = pending_balance_object.owner;
+               amounts_paid_out_by_asset[pending_balance_object.dividend_payout_asset_type] += pending_balance_object.pending_balance;
 
+               db.modify(pending_balance_object, [&]( pending_dividend_payout_balance_for_holder_object& pending_balance ){
+                  pending_balance.pending_balance = 0;
+               });
             }
 
-            // now schedule the next payout time
-            db.modify(dividend_data, [current_head_block_time](asset_dividend_data_object& dividend_data_obj) {
-               dividend_data_obj.last_scheduled_payout_time = dividend_data_obj.options.next_payout_time;
-               dividend_data_obj.last_payout_time = current_head_block_time;
-               fc::optional<fc::time_point_sec> next_payout_time;
-               if (dividend_data_obj.options.payout_interval)
-               {
-                  // if there was a previous payout, make our next payment one interval 
-                  uint32_t current_time_sec = current_head_block_time.sec_since_epoch();
-                  fc::time_point_sec reference_time = *dividend_data_obj.last_scheduled_payout_time;
-                  uint32_t next_possible_time_sec = dividend_data_obj.last_scheduled_payout_time->sec_since_epoch();
-                  do
-                     next_possible_time_sec += *dividend_data_obj.options.payout_interval;
-                  while (next_possible_time_sec <= current_time_sec);
-
-                  next_payout_time = next_possible_time_sec;
-               }
-               dividend_data_obj.options.next_payout_time = next_payout_time;
-               idump((dividend_data_obj.last_scheduled_payout_time)
-                     (dividend_data_obj.last_payout_time)
-                     (dividend_data_obj.options.next_payout_time));
-            });
+            ++pending_balance_object_iter;
+         }
+         // we will always be left with the last holder's data, generate the virtual op for it now.
+         if (last_holder_account_id && payouts_for_this_holder.size())
+         {
+            // we've moved on to a new account, generate the dividend payment virtual op for the previous one
+            db.push_applied_operation(asset_dividend_distribution_operation(dividend_holder_asset_obj.id, 
+                                                                            *last_holder_account_id, 
+                                                                            payouts_for_this_holder));
+            dlog("Just pushed virtual op for payout to ${account}", ("account", (*last_holder_account_id)(db).name));
+         }
+
+         // now debit the total amount of dividends paid out from the distribution account
+         // and reduce the distributed_balances accordingly
+
+         for (const auto& value : amounts_paid_out_by_asset)
+         {
+            const asset_id_type& asset_paid_out = value.first;
+            const share_type& amount_paid_out = value.second;
+
+            db.adjust_balance(dividend_data.dividend_distribution_account, 
+                              asset(-amount_paid_out,
+                                    asset_paid_out));
+            auto distributed_balance_iter = 
+               distributed_dividend_balance_index.indices().get<by_dividend_payout_asset>().find(boost::make_tuple(dividend_holder_asset_obj.id, 
+                                                                                                                   asset_paid_out));
+            assert(distributed_balance_iter != distributed_dividend_balance_index.indices().get<by_dividend_payout_asset>().end());
+            if (distributed_balance_iter != distributed_dividend_balance_index.indices().get<by_dividend_payout_asset>().end())
+               db.modify(*distributed_balance_iter, [&]( total_distributed_dividend_balance_object& obj ){
+                  obj.balance_at_last_maintenance_interval -= amount_paid_out; // now they've been paid out, reset to zero
+               });
+
          }
+
+         // now schedule the next payout time
+         db.modify(dividend_data, [current_head_block_time](asset_dividend_data_object& dividend_data_obj) {
+            dividend_data_obj.last_scheduled_payout_time = dividend_data_obj.options.next_payout_time;
+            dividend_data_obj.last_payout_time = current_head_block_time;
+            fc::optional<fc::time_point_sec> next_payout_time;
+            if (dividend_data_obj.options.payout_interval)
+            {
+               // if there was a previous payout, make our next payment one interval 
+               uint32_t current_time_sec = current_head_block_time.sec_since_epoch();
+               fc::time_point_sec reference_time = *dividend_data_obj.last_scheduled_payout_time;
+               uint32_t next_possible_time_sec = dividend_data_obj.last_scheduled_payout_time->sec_since_epoch();
+               do
+                  next_possible_time_sec += *dividend_data_obj.options.payout_interval;
+               while (next_possible_time_sec <= current_time_sec);
+
+               next_payout_time = next_possible_time_sec;
+            }
+            dividend_data_obj.options.next_payout_time = next_payout_time;
+            idump((dividend_data_obj.last_scheduled_payout_time)
+                  (dividend_data_obj.last_payout_time)
+                  (dividend_data_obj.options.next_payout_time));
+         });
       }
+   }
 }
 
 void database::perform_chain_maintenance(const signed_block& next_block, const global_property_object& global_props)
@@ -1214,29 +1249,20 @@ void database::perform_chain_maintenance(const signed_block& next_block, const g
    struct vote_tally_helper {
       database& d;
       const global_property_object& props;
-      std::map<account_id_type, share_type> vesting_amounts;
+      /// core asset vesting balances, indexed by the instance of the owning account
+      const vector<share_type>& vesting_amounts;
 
-      vote_tally_helper(database& d, const global_property_object& gpo)
-         : d(d), props(gpo)
-      {
-         d._vote_tally_buffer.resize(props.next_available_vote_id);
-         d._witness_count_histogram_buffer.resize(props.parameters.maximum_witness_count / 2 + 1);
-         d._committee_count_histogram_buffer.resize(props.parameters.maximum_committee_count / 2 + 1);
-         d._total_voting_stake = 0;
-
-         const vesting_balance_index& vesting_index = d.get_index_type<vesting_balance_index>();
-         auto vesting_balances_begin =
-              vesting_index.indices().get<by_asset_balance>().lower_bound(boost::make_tuple(asset_id_type()));
-         auto vesting_balances_end =
-              vesting_index.indices().get<by_asset_balance>().upper_bound(boost::make_tuple(asset_id_type(), share_type()));
-         for (const vesting_balance_object& vesting_balance_obj : boost::make_iterator_range(vesting_balances_begin, vesting_balances_end))
-         {
-            vesting_amounts[vesting_balance_obj.owner] += vesting_balance_obj.balance.amount;
-            //dlog("Vesting balance for account: ${owner}, amount: ${amount}",
-            //     ("owner", vesting_balance_obj.owner(d).name)
-            //     ("amount", vesting_balance_obj.balance.amount));
-         }
-      }
+      vector<uint64_t> vote_tally_buffer;
+      vector<uint64_t> witness_count_histogram_buffer;
+      vector<uint64_t> committee_count_histogram_buffer;
+      uint64_t         total_voting_stake = 0;
+
+      vote_tally_helper(database& d, const global_property_object& gpo, const vector<share_type>& vesting_amounts)
+         : d(d), props(gpo), vesting_amounts(vesting_amounts),
+           vote_tally_buffer(gpo.next_available_vote_id),
+           witness_count_histogram_buffer(gpo.parameters.maximum_witness_count / 2 + 1),
+           committee_count_histogram_buffer(gpo.parameters.maximum_committee_count / 2 + 1)
+      {}
 
       void operator()(const account_object& stake_account) {
          if( props.parameters.count_non_member_votes || stake_account.is_member(d.head_block_time()) )
@@ -1259,61 +1285,214 @@ void database::perform_chain_maintenance(const signed_block& next_block, const g
                   + (stake_account.cashback_vb.valid() ? (*stake_account.cashback_vb)(d).balance.amount.value: 0)
                   + d.get_balance(stake_account.get_id(), asset_id_type()).amount.value;
 
-            auto itr = vesting_amounts.find(stake_account.id);
-            if (itr != vesting_amounts.end())
-                voting_stake += itr->second.value;
+            if( stake_account.id.instance() < vesting_amounts.size() )
+               voting_stake += vesting_amounts[stake_account.id.instance()].value;
 
             for( vote_id_type id : opinion_account.options.votes )
             {
                uint32_t offset = id.instance();
                // if they somehow managed to specify an illegal offset, ignore it.
-               if( offset < d._vote_tally_buffer.size() )
-                  d._vote_tally_buffer[offset] += voting_stake;
+               if( offset < vote_tally_buffer.size() )
+                  vote_tally_buffer[offset] += voting_stake;
             }
 
             if( opinion_account.options.num_witness <= props.parameters.maximum_witness_count )
             {
                uint16_t offset = std::min(size_t(opinion_account.options.num_witness/2),
-                                          d._witness_count_histogram_buffer.size() - 1);
+                                          witness_count_histogram_buffer.size() - 1);
                // votes for a number greater than maximum_witness_count
                // are turned into votes for maximum_witness_count.
                //
                // in particular, this takes care of the case where a
                // member was voting for a high number, then the
                // parameter was lowered.
-               d._witness_count_histogram_buffer[offset] += voting_stake;
+               witness_count_histogram_buffer[offset] += voting_stake;
             }
             if( opinion_account.options.num_committee <= props.parameters.maximum_committee_count )
             {
                uint16_t offset = std::min(size_t(opinion_account.options.num_committee/2),
-                                          d._committee_count_histogram_buffer.size() - 1);
+                                          committee_count_histogram_buffer.size() - 1);
                // votes for a number greater than maximum_committee_count
                // are turned into votes for maximum_committee_count.
                //
                // same rationale as for witnesses
-               d._committee_count_histogram_buffer[offset] += voting_stake;
+               committee_count_histogram_buffer[offset] += voting_stake;
             }
 
-            d._total_voting_stake += voting_stake;
+            total_voting_stake += voting_stake;
          }
       }
-   } tally_helper(*this, gpo);
-   struct process_fees_helper {
-      database& d;
-      const global_property_object& props;
 
-      process_fees_helper(database& d, const global_property_object& gpo)
-         : d(d), props(gpo) {}
+      /// adds this helper's tally into the database's tally buffers
+      void add_to_database()const {
+         for( size_t i = 0; i < vote_tally_buffer.size(); ++i )
+            d._vote_tally_buffer[i] += vote_tally_buffer[i];
+         for( size_t i = 0; i < witness_count_histogram_buffer.size(); ++i )
+            d._witness_count_histogram_buffer[i] += witness_count_histogram_buffer[i];
+         for( size_t i = 0; i < committee_count_histogram_buffer.size(); ++i )
+            d._committee_count_histogram_buffer[i] += committee_count_histogram_buffer[i];
+         d._total_voting_stake += total_voting_stake;
+      }
+   };
+
+   // the incremental tallies count every account, so they can't be used when only members may vote
+   const node_property_object& node_props = get_node_properties();
+   const bool incremental_tally = node_props.incremental_vote_tally && gpo.parameters.count_non_member_votes;
+   const bool full_tally = !incremental_tally || node_props.check_vote_tally;
+   if( incremental_tally && !_vote_tally_tracker )
+      init_vote_tally_tracker();
+
+   _vote_tally_buffer.resize(gpo.next_available_vote_id);
+   _witness_count_histogram_buffer.resize(gpo.parameters.maximum_witness_count / 2 + 1);
+   _committee_count_histogram_buffer.resize(gpo.parameters.maximum_committee_count / 2 + 1);
+   _total_voting_stake = 0;
+
+   const auto& account_idx = get_index_type<account_index>();
+   const uint64_t account_count = account_idx.get_next_id().instance();
+
+   vector<share_type> vesting_amounts;
+   if( full_tally )
+   {
+      vesting_amounts.resize(account_count);
+      const vesting_balance_index& vesting_index = get_index_type<vesting_balance_index>();
+      auto vesting_balances_begin =
+           vesting_index.indices().get<by_asset_balance>().lower_bound(boost::make_tuple(asset_id_type()));
+      auto vesting_balances_end =
+           vesting_index.indices().get<by_asset_balance>().upper_bound(boost::make_tuple(asset_id_type(), share_type()));
+      for (const vesting_balance_object& vesting_balance_obj : boost::make_iterator_range(vesting_balances_begin, vesting_balances_end))
+         vesting_amounts[vesting_balance_obj.owner.instance.value] += vesting_balance_obj.balance.amount;
+   }
+
+   // Votes used to be tallied and fees processed account by account in name order. Processing the fees of an
+   // account deposits cashback into the vesting balances of its referrers and registrar, which changes the voting
+   // stake of those accounts if they come later in that order. Every other account's stake does not depend on the
+   // fee processing, so those accounts are tallied in parallel up front; the fee recipients are tallied in between
+   // the fee processing, in name order, exactly as before.
+   flat_set<account_id_type> fee_recipients;
+   vector<const account_object*> accounts_with_fees;
+   for( const account_statistics_object& stats : get_index_type<simple_index<account_statistics_object>>() )
+   {
+      if( stats.pending_fees > 0 || stats.pending_vested_fees > 0 )
+      {
+         const account_object& a = stats.owner(*this);
+         accounts_with_fees.push_back(&a);
+         fee_recipients.insert(a.lifetime_referrer);
+         fee_recipients.insert(a.referrer);
+         fee_recipients.insert(a.registrar);
+      }
+   }
+
+   auto cashback_balance = [this]( const account_object& a ) {
+      return a.cashback_vb.valid() ? (*a.cashback_vb)(*this).balance.amount : share_type();
+   };
+
+   // The incremental tallies reflect the stakes before any fees are processed. The full tally sees the cashback
+   // deposited into a recipient by the fees processed before its turn, so that is added when its turn comes.
+   vote_tally_buffers incremental_buffers;
+   flat_map<account_id_type, share_type> cashback_before_fees;
+   if( incremental_tally )
+   {
+      _vote_tally_tracker->get_tally(gpo, incremental_buffers);
+      for( account_id_type id : fee_recipients )
+         cashback_before_fees[id] = cashback_balance(id(*this));
+   }
+
+   if( full_tally )
+   {
+      // unless configured otherwise, use one thread per core but don't bother with threads for small account sets
+      const uint64_t min_accounts_per_thread = 10000;
+      uint64_t thread_count = get_node_properties().maintenance_threads;
+      if( thread_count == 0 )
+         thread_count = std::min<uint64_t>(std::thread::hardware_concurrency(), account_count / min_accounts_per_thread);
+      thread_count = std::max<uint64_t>(1, std::min<uint64_t>(thread_count, account_count));
+
+      vector<vote_tally_helper> tally_helpers;
+      tally_helpers.reserve(thread_count);
+      for( uint64_t t = 0; t < thread_count; ++t )
+         tally_helpers.emplace_back(*this, gpo, vesting_amounts);
+
+      // accounts are never removed, so their ids split evenly into contiguous ranges
+      auto tally_range = [&]( uint64_t t ) {
+         auto itr = account_idx.indices().get<by_id>().lower_bound(account_id_type(account_count * t / thread_count));
+         auto end = account_idx.indices().get<by_id>().lower_bound(account_id_type(account_count * (t + 1) / thread_count));
+         for( ; itr != end; ++itr )
+            if( fee_recipients.find(itr->get_id()) == fee_recipients.end() )
+               tally_helpers[t](*itr);
+      };
+
+      vector<std::thread> threads;
+      vector<std::exception_ptr> errors(thread_count);
+      for( uint64_t t = 1; t < thread_count; ++t )
+         threads.emplace_back([&, t]() {
+            try {
+               tally_range(t);
+            } catch( ... ) {
+               errors[t] = std::current_exception();
+            }
+         });
+      try {
+         tally_range(0);
+      } catch( ... ) {
+         errors[0] = std::current_exception();
+      }
+      for( std::thread& thread : threads )
+         thread.join();
+      for( const std::exception_ptr& error : errors )
+         if( error )
+            std::rethrow_exception(error);
+
+      for( const vote_tally_helper& helper : tally_helpers )
+         helper.add_to_database();
+   }
 
-      void operator()(const account_object& a) {
-         a.statistics(d).process_fees(a, d);
+   {
+      vector<const account_object*> accounts_in_order = accounts_with_fees;
+      for( account_id_type id : fee_recipients )
+         accounts_in_order.push_back(&id(*this));
+      std::sort(accounts_in_order.begin(), accounts_in_order.end(),
+                [](const account_object* a, const account_object* b) { return a->name < b->name; });
+      accounts_in_order.erase(std::unique(accounts_in_order.begin(), accounts_in_order.end()), accounts_in_order.end());
+
+      vote_tally_helper recipient_tally(*this, gpo, vesting_amounts);
+      for( const account_object* a : accounts_in_order )
+      {
+         if( fee_recipients.find(a->get_id()) != fee_recipients.end() )
+         {
+            if( full_tally )
+               recipient_tally(*a);
+            if( incremental_tally )
+               _vote_tally_tracker->add_stake_to_tally(a->get_id(), cashback_balance(*a) - cashback_before_fees[a->get_id()],
+                                                       gpo, incremental_buffers);
+         }
+         a->statistics(*this).process_fees(*a, *this);
       }
-   } fee_helper(*this, gpo);
+      if( full_tally )
+         recipient_tally.add_to_database();
+   }
 
-   perform_account_maintenance(std::tie(
-      tally_helper,
-      fee_helper
-      ));
+   if( incremental_tally && !full_tally )
+   {
+      _vote_tally_buffer = std::move(incremental_buffers.vote_tally);
+      _witness_count_histogram_buffer = std::move(incremental_buffers.witness_count_histogram);
+      _committee_count_histogram_buffer = std::move(incremental_buffers.committee_count_histogram);
+      _total_voting_stake = incremental_buffers.total_voting_stake;
+   }
+   else if( incremental_tally )
+   {
+      vote_tally_buffers full_buffers;
+      full_buffers.vote_tally = _vote_tally_buffer;
+      full_buffers.witness_count_histogram = _witness_count_histogram_buffer;
+      full_buffers.committee_count_histogram = _committee_count_histogram_buffer;
+      full_buffers.total_voting_stake = _total_voting_stake;
+      if( !(incremental_buffers == full_buffers) )
+      {
+         elog( "Incremental vote tally differs from the full tally at block ${n} (total voting stake ${incremental} vs ${full}), "
+               "using the full tally and recounting",
+               ("n", next_block.block_num())("incremental", incremental_buffers.total_voting_stake)
+               ("full", full_buffers.total_voting_stake) );
+         init_vote_tally_tracker();
+      }
+   }
 
    struct clear_canary {
       clear_canary(vector<uint64_t>& target): target(target){}
@@ -34,12 +34,15 @@
 #include <graphene/chain/withdraw_permission_object.hpp>
 #include <graphene/chain/witness_object.hpp>
 #include <graphene/chain/tournament_object.hpp>
+#include <graphene/chain/match_object.hpp>
 #include <graphene/chain/game_object.hpp>
 
 #include <graphene/chain/protocol/fee_schedule.hpp>
 
 #include <fc/uint128.hpp>
 
+#include <algorithm>
+
 namespace graphene { namespace chain {
 
 void database::update_global_dynamic_data( const signed_block& b )
@@ -184,8 +187,15 @@ void database::clear_expired_transactions()
    //Transactions must have expired by at least two forking windows in order to be removed.
    auto& transaction_idx = static_cast<transaction_index&>(get_mutable_index(implementation_ids, impl_transaction_object_type));
    const auto& dedupe_index = transaction_idx.indices().get<by_expiration>();
-   while( (!dedupe_index.empty()) && (head_block_time() > dedupe_index.begin()->trx.expiration) )
+   while( (!dedupe_index.empty()) && (head_block_time() > dedupe_index.begin()->expiration) )
       transaction_idx.remove(*dedupe_index.begin());
+   _validated_tx.remove_expired( head_block_time() );
+   // pending and popped transactions which expired can't be applied again, don't keep them to re-push
+   const time_point_sec now = head_block_time();
+   _pending_tx.remove_expired( now );
+   _popped_tx.erase( std::remove_if( _popped_tx.begin(), _popped_tx.end(),
+                                     [now]( const signed_transaction& tx ) { return tx.expiration < now; } ),
+                     _popped_tx.end() );
 } FC_CAPTURE_AND_RETHROW() }
 
 void database::clear_expired_proposals()
@@ -446,34 +456,70 @@ void database::clear_expired_orders()
    }
 } FC_CAPTURE_AND_RETHROW() }
 
+void database::update_expired_feed( const asset_object& a )
+{
+   assert( a.is_market_issued() );
+
+   const asset_bitasset_data_object& b = a.bitasset_data(*this);
+   bool feed_is_expired;
+   if( head_block_time() < HARDFORK_615_TIME )
+      feed_is_expired = b.feed_is_expired_before_hardfork_615( head_block_time() );
+   else
+      feed_is_expired = b.feed_is_expired( head_block_time() );
+   if( feed_is_expired )
+   {
+      modify(b, [this](asset_bitasset_data_object& a) {
+         a.update_median_feeds(head_block_time());
+      });
+      check_call_orders(b.current_feed.settlement_price.base.asset_id(*this));
+   }
+   if( !b.current_feed.core_exchange_rate.is_null() &&
+       a.options.core_exchange_rate != b.current_feed.core_exchange_rate )
+      modify(a, [&b](asset_object& a) {
+         a.options.core_exchange_rate = b.current_feed.core_exchange_rate;
+      });
+}
+
 void database::update_expired_feeds()
 {
-   auto& asset_idx = get_index_type<asset_index>().indices().get<by_type>();
-   auto itr = asset_idx.lower_bound( true /** market issued */ );
-   while( itr != asset_idx.end() )
+   // take the bitassets changed up to now; the ones changed from here on (including by the updates
+   // themselves) will be looked at in the next block
+   auto& feed_expiration_idx = get_mutable_index_type< primary_index<asset_bitasset_data_index> >()
+                                  .get_secondary_index<bitasset_feed_expiration_index>();
+   flat_set<asset_id_type> assets_to_update;
+   std::swap( assets_to_update, feed_expiration_idx.changed_assets );
+   auto& asset_change_idx = get_mutable_index_type< primary_index<asset_index> >()
+                               .get_secondary_index<market_issued_asset_change_index>();
+   assets_to_update.insert( asset_change_idx.changed_assets.begin(), asset_change_idx.changed_assets.end() );
+   asset_change_idx.changed_assets.clear();
+
+   if( head_block_time() < HARDFORK_615_TIME )
    {
-      const asset_object& a = *itr;
-      ++itr;
-      assert( a.is_market_issued() );
-
-      const asset_bitasset_data_object& b = a.bitasset_data(*this);
-      bool feed_is_expired;
-      if( head_block_time() < HARDFORK_615_TIME )
-         feed_is_expired = b.feed_is_expired_before_hardfork_615( head_block_time() );
-      else
-         feed_is_expired = b.feed_is_expired( head_block_time() );
-      if( feed_is_expired )
+      // before the fix every feed that has not expired yet counted as expired, so look at all bitassets
+      auto& asset_idx = get_index_type<asset_index>().indices().get<by_type>();
+      auto itr = asset_idx.lower_bound( true /** market issued */ );
+      while( itr != asset_idx.end() )
       {
-         modify(b, [this](asset_bitasset_data_object& a) {
-            a.update_median_feeds(head_block_time());
-         });
-         check_call_orders(b.current_feed.settlement_price.base.asset_id(*this));
+         const asset_object& a = *itr;
+         ++itr;
+         update_expired_feed( a );
       }
-      if( !b.current_feed.core_exchange_rate.is_null() &&
-          a.options.core_exchange_rate != b.current_feed.core_exchange_rate )
-         modify(a, [&b](asset_object& a) {
-            a.options.core_exchange_rate = b.current_feed.core_exchange_rate;
-         });
+      return;
+   }
+
+   // after a block is applied every core exchange rate matches its feed, so apart from the bitassets
+   // whose feed expired only the ones changed since then can need an update; asset ids order the
+   // updates like the walk over all market issued assets did
+   for( auto itr = feed_expiration_idx.feed_expirations.begin();
+        itr != feed_expiration_idx.feed_expirations.end() && itr->first <= head_block_time(); ++itr )
+      assets_to_update.insert( itr->second );
+
+   for( asset_id_type id : assets_to_update )
+   {
+      // assets created by pending transactions which were undone again are listed as well
+      const asset_object* a = find( id );
+      if( a != nullptr && a->is_market_issued() )
+         update_expired_feed( *a );
    }
 }
 
@@ -510,16 +556,15 @@ void process_finished_matches(database& db)
 {
 }
 
-void process_in_progress_tournaments(database& db)
+void process_in_progress_tournaments(database& db, const flat_set<tournament_id_type>& changed_tournaments)
 {
-   auto& start_time_index = db.get_index_type<tournament_index>().indices().get<by_start_time>();
-   auto start_iter = start_time_index.lower_bound(boost::make_tuple(tournament_state::in_progress));
-   while (start_iter != start_time_index.end() &&
-          start_iter->get_state() == tournament_state::in_progress)
+   // checking a tournament whose matches haven't changed since its last check has no effect,
+   // so only the tournaments with changed matches need to be looked at
+   for (const tournament_id_type& tournament_id : changed_tournaments)
    {
-      auto next_iter = std::next(start_iter);
-      start_iter->check_for_new_matches_to_start(db);
-      start_iter = next_iter;
+      const tournament_object* tournament_obj = db.find(tournament_id);
+      if (tournament_obj && tournament_obj->get_state() == tournament_state::in_progress)
+         tournament_obj->check_for_new_matches_to_start(db);
    }
 }
 
@@ -603,7 +648,13 @@ void database::update_tournaments()
    process_finished_matches(*this);
    cancel_expired_tournaments(*this);
    start_fully_registered_tournaments(*this);
-   process_in_progress_tournaments(*this);
+
+   // take the tournaments whose matches changed up to now; matches changed from here on (including
+   // by the checks themselves) will be looked at in the next block
+   flat_set<tournament_id_type> changed_tournaments;
+   std::swap(changed_tournaments,
+             get_mutable_index_type< primary_index<match_index> >().get_secondary_index<tournament_match_change_index>().changed_tournaments);
+   process_in_progress_tournaments(*this, changed_tournaments);
    initiate_next_round_of_matches(*this);
    initiate_next_games(*this);
 }
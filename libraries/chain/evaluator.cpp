@@ -55,11 +55,11 @@ database& generic_evaluator::db()const { return trx_state->db(); }
       const database& d = db();
       fee_from_account = fee;
       FC_ASSERT( fee.amount >= 0 );
-      fee_paying_account = &account_id(d);
-      fee_paying_account_statistics = &fee_paying_account->statistics(d);
+      fee_paying_account = &trx_state->get_account(account_id);
+      fee_paying_account_statistics = &trx_state->get_account_statistics(*fee_paying_account);
 
-      fee_asset = &fee.asset_id(d);
-      fee_asset_dyn_data = &fee_asset->dynamic_asset_data_id(d);
+      fee_asset = &trx_state->get_asset(fee.asset_id);
+      fee_asset_dyn_data = &trx_state->get_asset_dynamic_data(*fee_asset);
 
       if( d.head_block_time() > HARDFORK_419_TIME )
       {
@@ -99,7 +99,7 @@ database& generic_evaluator::db()const { return trx_state->db(); }
          /// TODO: db().pay_fee( account_id, core_fee );
          d.modify(*fee_paying_account_statistics, [&](account_statistics_object& s)
          {
-            s.pay_fee( core_fee_paid, d.get_global_properties().parameters.cashback_vesting_threshold );
+            s.pay_fee( core_fee_paid, trx_state->get_global_properties().parameters.cashback_vesting_threshold );
          });
       }
    } FC_CAPTURE_AND_RETHROW() }
@@ -24,9 +24,17 @@
 #include <graphene/chain/fork_database.hpp>
 #include <graphene/chain/exceptions.hpp>
 #include <graphene/chain/protocol/fee_schedule.hpp>
+#include <fc/io/raw.hpp>
 #include <fc/smart_ref_impl.hpp>
 
 namespace graphene { namespace chain {
+const vector<char>& fork_item::packed_data()const
+{
+   if( _packed_data.empty() )
+      _packed_data = fc::raw::pack( data );
+   return _packed_data;
+}
+
 fork_database::fork_database()
 {
 }
@@ -57,13 +65,22 @@ void     fork_database::start_block(signed_block b)
  */
 shared_ptr<fork_item>  fork_database::push_block(const signed_block& b)
 {
-   auto item = std::make_shared<fork_item>(b);
+   return _push_item( std::make_shared<fork_item>(b) );
+}
+
+shared_ptr<fork_item>  fork_database::push_block(signed_block&& b)
+{
+   return _push_item( std::make_shared<fork_item>(std::move(b)) );
+}
+
+shared_ptr<fork_item>  fork_database::_push_item(const item_ptr& item)
+{
    try {
       _push_block(item);
    }
    catch ( const unlinkable_block_exception& e )
    {
-      wlog( "Pushing block to fork database that failed to link: ${id}, ${num}", ("id",b.id())("num",b.block_num()) );
+      wlog( "Pushing block to fork database that failed to link: ${id}, ${num}", ("id",item->id)("num",item->num) );
       wlog( "Head: ${num}, ${id}", ("num",_head->data.block_num())("id",_head->data.id()) );
       throw;
       _unlinked_index.insert( item );
@@ -211,13 +228,13 @@ pair<fork_database::branch_type,fork_database::branch_type>
    auto second_branch = *second_branch_itr;
 
 
-   while( first_branch->data.block_num() > second_branch->data.block_num() )
+   while( first_branch->num > second_branch->num )
    {
       result.first.push_back(first_branch);
       first_branch = first_branch->prev.lock();
       FC_ASSERT(first_branch);
    }
-   while( second_branch->data.block_num() > first_branch->data.block_num() )
+   while( second_branch->num > first_branch->num )
    {
       result.second.push_back( second_branch );
       second_branch = second_branch->prev.lock();
@@ -305,6 +305,36 @@ namespace graphene { namespace chain {
       return *this;
    }
 
+   // moving hands the state machine over instead of allocating and copying a new one; undo
+   // restores objects with move_from(), and create() moves the new object into the index
+   game_object::game_object(game_object&& rhs) :
+      graphene::db::abstract_object<game_object>(rhs),
+      match_id(rhs.match_id),
+      players(std::move(rhs.players)),
+      winners(std::move(rhs.winners)),
+      game_details(std::move(rhs.game_details)),
+      next_timeout(std::move(rhs.next_timeout)),
+      my(std::move(rhs.my))
+   {
+      my->state_machine.game_obj = this;
+   }
+
+   game_object& game_object::operator=(game_object&& rhs)
+   {
+      id = rhs.id;
+      match_id = rhs.match_id;
+      players = std::move(rhs.players);
+      winners = std::move(rhs.winners);
+      game_details = std::move(rhs.game_details);
+      next_timeout = std::move(rhs.next_timeout);
+      std::swap(my, rhs.my);
+      my->state_machine.game_obj = this;
+      if (rhs.my)
+         rhs.my->state_machine.game_obj = &rhs;
+
+      return *this;
+   }
+
    game_object::~game_object()
    {
    }
@@ -551,8 +581,6 @@ namespace fc {
    // Manually reflect game_object to variant to properly reflect "state"
    void to_variant(const graphene::chain::game_object& game_obj, fc::variant& v)
    {
-      fc_elog(fc::logger::get("tournament"), "In game_obj to_variant");
-      elog("In game_obj to_variant");
       fc::mutable_variant_object o;
       o("id", game_obj.id)
        ("match_id", game_obj.match_id)
@@ -568,7 +596,6 @@ namespace fc {
    // Manually reflect game_object to variant to properly reflect "state"
    void from_variant(const fc::variant& v, graphene::chain::game_object& game_obj)
    {
-      fc_elog(fc::logger::get("tournament"), "In game_obj from_variant");
       game_obj.id = v["id"].as<graphene::chain::game_id_type>();
       game_obj.match_id = v["match_id"].as<graphene::chain::match_id_type>();
       game_obj.players = v["players"].as<std::vector<graphene::chain::account_id_type> >();
@@ -23,8 +23,9 @@
  */
 #pragma once
 #include <graphene/chain/protocol/operations.hpp>
-#include <graphene/db/generic_index.hpp>
+#include <graphene/db/dense_index.hpp>
 #include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
 
 namespace graphene { namespace chain {
    class database;
@@ -335,6 +336,7 @@ namespace graphene { namespace chain {
 
 
    struct by_account_asset;
+   struct by_account_asset_hash;
    struct by_asset_balance;
    /**
     * @ingroup object_index
@@ -350,6 +352,14 @@ namespace graphene { namespace chain {
                member<account_balance_object, asset_id_type, &account_balance_object::asset_type>
             >
          >,
+         /// the same key as by_account_asset for point lookups, which don't need the ordering
+         hashed_unique< tag<by_account_asset_hash>,
+            composite_key<
+               account_balance_object,
+               member<account_balance_object, account_id_type, &account_balance_object::owner>,
+               member<account_balance_object, asset_id_type, &account_balance_object::asset_type>
+            >
+         >,
          ordered_unique< tag<by_asset_balance>,
             composite_key<
                account_balance_object,
@@ -369,25 +379,30 @@ namespace graphene { namespace chain {
    /**
     * @ingroup object_index
     */
-   typedef generic_index<account_balance_object, account_balance_object_multi_index_type> account_balance_index;
+   typedef dense_index<account_balance_object, account_balance_object_multi_index_type> account_balance_index;
 
    struct by_name{};
+   struct by_name_hash{};
 
    /**
     * @ingroup object_index
+    *
+    * by_name keeps the accounts in name order for listing by prefix and for maintenance, which processes
+    * accounts in that order; exact name lookups should use by_name_hash.
     */
    typedef multi_index_container<
       account_object,
       indexed_by<
          ordered_unique< tag<by_id>, member< object, object_id_type, &object::id > >,
-         ordered_unique< tag<by_name>, member<account_object, string, &account_object::name> >
+         ordered_unique< tag<by_name>, member<account_object, string, &account_object::name> >,
+         hashed_unique< tag<by_name_hash>, member<account_object, string, &account_object::name> >
       >
    > account_multi_index_type;
 
    /**
     * @ingroup object_index
     */
-   typedef generic_index<account_object, account_multi_index_type> account_index;
+   typedef dense_index<account_object, account_multi_index_type> account_index;
 
    struct by_dividend_payout_account{}; // use when calculating pending payouts
    struct by_dividend_account_payout{}; // use when doing actual payouts
@@ -25,7 +25,7 @@
 #include <graphene/chain/protocol/asset_ops.hpp>
 #include <boost/multi_index/composite_key.hpp>
 #include <graphene/db/flat_index.hpp>
-#include <graphene/db/generic_index.hpp>
+#include <graphene/db/dense_index.hpp>
 
 /**
  * @defgroup prediction_market Prediction Market
@@ -87,6 +87,8 @@ namespace graphene { namespace chain {
 
          /// @return true if this is a market-issued asset; false otherwise.
          bool is_market_issued()const { return bitasset_data_id.valid(); }
+         /// @return true if this asset pays dividends to its holders
+         bool is_dividend_holder_asset()const { return dividend_data_id.valid(); }
          /// @return true if users may request force-settlement of this market-issued asset; false otherwise
          bool can_force_settle()const { return !(options.flags & disable_force_settle); }
          /// @return true if the issuer of this market-issued asset may globally settle the asset; false otherwise
@@ -179,6 +181,9 @@ namespace graphene { namespace chain {
          static const uint8_t space_id = implementation_ids;
          static const uint8_t type_id  = impl_asset_bitasset_data_type;
 
+         /// The asset this object belongs to
+         asset_id_type asset_id;
+
          /// The tunable options for BitAssets are stored in this field.
          bitasset_options options;
 
@@ -237,8 +242,29 @@ namespace graphene { namespace chain {
    > asset_bitasset_data_object_multi_index_type;
    typedef flat_index<asset_bitasset_data_object> asset_bitasset_data_index;
 
+   /**
+    * @brief Keeps the bitassets in the order their price feeds expire
+    *
+    * Also collects the bitassets created or changed since database::update_expired_feeds last looked at
+    * them, so that it only needs to visit those and the ones whose feed is due instead of every bitasset.
+    * Undo goes through modify(), insert() and remove() as well, so the expirations always match the
+    * objects; a bitasset being collected without need only costs a redundant check.
+    */
+   class bitasset_feed_expiration_index : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         set< pair<time_point_sec, asset_id_type> > feed_expirations;
+         flat_set<asset_id_type>                    changed_assets;
+   };
+
    struct by_symbol;
    struct by_type;
+   struct by_dividend_holder;
    typedef multi_index_container<
       asset_object,
       indexed_by<
@@ -249,10 +275,29 @@ namespace graphene { namespace chain {
                 const_mem_fun<asset_object, bool, &asset_object::is_market_issued>,
                 member< object, object_id_type, &object::id >
             >
+         >,
+         ordered_unique< tag<by_dividend_holder>,
+            composite_key< asset_object,
+                const_mem_fun<asset_object, bool, &asset_object::is_dividend_holder_asset>,
+                member< object, object_id_type, &object::id >
+            >
          >
       >
    > asset_object_multi_index_type;
-   typedef generic_index<asset_object, asset_object_multi_index_type> asset_index;
+   typedef dense_index<asset_object, asset_object_multi_index_type> asset_index;
+
+   /**
+    * @brief Collects the market issued assets created or changed since database::update_expired_feeds last
+    * looked at them, see bitasset_feed_expiration_index
+    */
+   class market_issued_asset_change_index : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         flat_set<asset_id_type> changed_assets;
+   };
 
    /**
     *  @brief contains properties that only apply to dividend-paying assets
@@ -338,6 +383,7 @@ FC_REFLECT_DERIVED( graphene::chain::asset_dynamic_data_object, (graphene::db::o
                     (current_supply)(confidential_supply)(accumulated_fees)(fee_pool) )
 
 FC_REFLECT_DERIVED( graphene::chain::asset_bitasset_data_object, (graphene::db::object),
+                    (asset_id)
                     (feeds)
                     (current_feed)
                     (current_feed_publication_time)
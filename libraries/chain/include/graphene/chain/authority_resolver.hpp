@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <graphene/chain/protocol/transaction.hpp>
+#include <graphene/db/index.hpp>
+
+#include <tuple>
+
+namespace graphene { namespace chain {
+   class database;
+
+   /**
+    * @brief Verifies the authorities of transactions, remembering which combinations already passed
+    *
+    * Whether a transaction is authorized only depends on the accounts whose authorities it requires,
+    * the keys that signed it, the maximum authority depth, whether HARDFORK_ADDRESS_AUTH_TIME passed and
+    * the authorities of the accounts the verification fetches.  Once a combination passed, later
+    * transactions with the same requirements and signing keys, e.g. the many transfers of an exchange's
+    * hot wallet or the same transaction applied to the pending state and again in a block, skip walking
+    * the authority trees.
+    *
+    * Only verdicts that passed are remembered, transactions that need authorities other than those of
+    * accounts are always verified, and everything is forgotten when one of the fetched accounts is
+    * modified or removed, undo included, as reported by @ref authority_resolver_index on the account
+    * index.  The verdicts are those of graphene::chain::verify_authority().
+    */
+   class authority_resolver
+   {
+      public:
+         /// the combinations remembered before everything is forgotten, bounding the memory used
+         static const size_t max_verified = 100000;
+
+         /// throws like graphene::chain::verify_authority() unless @p trx signed by @p keys is authorized
+         void verify_authority( const database& db, const transaction& trx, const flat_set<public_key_type>& keys,
+                                uint32_t max_recursion_depth );
+
+         void object_removed( const object& obj );
+         void object_modified( const object& after );
+
+         /// forgets all verified combinations
+         void clear();
+
+         /// how often the authority trees were walked, and how often a remembered verdict spared it
+         uint64_t checks_performed()const { return _checks_performed; }
+         uint64_t checks_avoided()const { return _checks_avoided; }
+
+      private:
+         struct verified_authority
+         {
+            uint32_t                   max_recursion_depth = 0;
+            bool                       unmatched_addresses_signed = false;
+            flat_set<account_id_type>  required_active;
+            flat_set<account_id_type>  required_owner;
+            flat_set<public_key_type>  keys;
+
+            bool operator < ( const verified_authority& o )const
+            {
+               return std::tie( max_recursion_depth, unmatched_addresses_signed, required_active, required_owner, keys )
+                    < std::tie( o.max_recursion_depth, o.unmatched_addresses_signed, o.required_active, o.required_owner,
+                                o.keys );
+            }
+         };
+
+         void account_changed( account_id_type account );
+
+         set<verified_authority>     _verified;
+         /// the accounts whose authorities the remembered verdicts depend on
+         set<account_id_type>        _fetched_accounts;
+         uint64_t                    _checks_performed = 0;
+         uint64_t                    _checks_avoided = 0;
+   };
+
+   /**
+    * @brief Reports changes to the account index to an @ref authority_resolver
+    */
+   class authority_resolver_index : public secondary_index
+   {
+      public:
+         authority_resolver_index( authority_resolver& resolver ) : _resolver(resolver) {}
+
+         virtual void object_removed( const object& obj ) override { _resolver.object_removed( obj ); }
+         virtual void object_modified( const object& after ) override { _resolver.object_modified( after ); }
+
+      private:
+         authority_resolver& _resolver;
+   };
+
+} } // graphene::chain
@@ -35,12 +35,16 @@ namespace graphene { namespace chain {
          void close();
 
          void store( const block_id_type& id, const signed_block& b );
+         /** stores a block which has already been packed with fc::raw::pack */
+         void store( const block_id_type& id, const vector<char>& packed_block );
          void remove( const block_id_type& id );
 
          bool                   contains( const block_id_type& id )const;
          block_id_type          fetch_block_id( uint32_t block_num )const;
          optional<signed_block> fetch_optional( const block_id_type& id )const;
          optional<signed_block> fetch_by_number( uint32_t block_num )const;
+         /** the block exactly as stored, without unpacking it */
+         optional<vector<char>> fetch_packed_by_number( uint32_t block_num )const;
          optional<signed_block> last()const;
          optional<block_id_type> last_id()const;
       private:
@@ -28,8 +28,12 @@
 #include <graphene/chain/asset_object.hpp>
 #include <graphene/chain/fork_database.hpp>
 #include <graphene/chain/block_database.hpp>
+#include <graphene/chain/pending_transaction_pool.hpp>
+#include <graphene/chain/proposal_authorization_cache.hpp>
+#include <graphene/chain/authority_resolver.hpp>
 #include <graphene/chain/genesis_state.hpp>
 #include <graphene/chain/evaluator.hpp>
+#include <graphene/chain/vote_tally_tracker.hpp>
 
 #include <graphene/db/object_database.hpp>
 #include <graphene/db/object.hpp>
@@ -124,7 +128,10 @@ namespace graphene { namespace chain {
          block_id_type              get_block_id_for_num( uint32_t block_num )const;
          optional<signed_block>     fetch_block_by_id( const block_id_type& id )const;
          optional<signed_block>     fetch_block_by_number( uint32_t num )const;
-         const signed_transaction&  get_recent_transaction( const transaction_id_type& trx_id )const;
+         /** the block at height num packed with fc::raw::pack, the way block_database stores it */
+         optional<vector<char>>     fetch_packed_block_by_number( uint32_t num )const;
+         /** a transaction that is pending or in a block and hasn't expired, read back from the block log */
+         signed_transaction         get_recent_transaction( const transaction_id_type& trx_id )const;
          std::vector<block_id_type> get_block_ids_on_fork(block_id_type head_of_fork) const;
 
          /**
@@ -265,6 +272,18 @@ namespace graphene { namespace chain {
 
          node_property_object& node_properties();
 
+         /** the transactions that already passed the stateless checks, with how often they were spared */
+         const validated_transaction_cache&     get_validated_transactions()const;
+         /** what the object caches of the applied transactions' evaluation states saved */
+         const evaluation_cache_stats&          get_evaluation_cache_stats()const;
+         /** how far the approvals of the proposals got, see proposal_object::is_authorized_to_execute() */
+         proposal_authorization_cache&          get_proposal_authorizations();
+         /** the verified transaction authorities, see @ref authority_resolver */
+         authority_resolver&                    get_authority_resolver();
+         /** how many blocks generate_block() produced from the pending state, and how many by applying it again */
+         uint64_t                               blocks_produced_from_pending_state()const { return _blocks_from_pending_state; }
+         uint64_t                               blocks_produced_by_reapplying()const { return _blocks_by_reapplying; }
+
 
          uint32_t last_non_undoable_block_num() const;
          //////////////////// db_init.cpp ////////////////////
@@ -292,6 +311,8 @@ namespace graphene { namespace chain {
          asset get_balance(account_id_type owner, asset_id_type asset_id)const;
          /// This is an overloaded method.
          asset get_balance(const account_object& owner, const asset_object& asset_obj)const;
+         /** @return the balance object of owner in asset_id, or nullptr if there is none */
+         const account_balance_object* find_balance_object(account_id_type owner, asset_id_type asset_id)const;
 
          /**
           * @brief Adjust a particular account's balance in a given asset by a delta
@@ -420,8 +441,16 @@ namespace graphene { namespace chain {
          processed_transaction apply_transaction( const signed_transaction& trx, uint32_t skip = skip_nothing );
          operation_result      apply_operation( transaction_evaluation_state& eval_state, const operation& op );
       private:
-         void                  _apply_block( const signed_block& next_block );
+         void                  _apply_block( const signed_block& next_block, bool transactions_applied = false );
+         void                  _push_block_from_pending_state( const signed_block& new_block );
          processed_transaction _apply_transaction( const signed_transaction& trx );
+         /**
+          * Runs the stateless checks of the block's transactions with confidential operations, whose commitment
+          * sums and range proofs are expensive, on worker threads, and records those that pass in _validated_tx
+          * so that applying them doesn't check them again.  The ones that fail are left for _apply_transaction()
+          * to reject.
+          */
+         void                  verify_confidential_transactions( const signed_block& next_block );
 
          ///Steps involved in applying a new block
          ///@{
@@ -437,6 +466,7 @@ namespace graphene { namespace chain {
          void clear_expired_transactions();
          void clear_expired_proposals();
          void clear_expired_orders();
+         void update_expired_feed( const asset_object& a );
          void update_expired_feeds();
          void update_maintenance_flag( bool new_maintenance_flag );
          void update_withdraw_permissions();
@@ -455,13 +485,40 @@ namespace graphene { namespace chain {
          void update_active_witnesses();
          void update_active_committee_members();
          void update_worker_votes();
+         void init_vote_tally_tracker();
 
          template<class... Types>
          void perform_account_maintenance(std::tuple<Types...> helpers);
          ///@}
          ///@}
 
-         vector< processed_transaction >        _pending_tx;
+         pending_transaction_pool               _pending_tx;
+         /**
+          * What a block can be produced from _pending_tx_session with: the operation history of the
+          * transactions applied in the session, how many of _pending_tx the session holds, and the skip
+          * flags they were applied with.
+          */
+         vector<optional<operation_history_object> >  _pending_tx_ops;
+         size_t                                 _pending_tx_in_session = 0;
+         uint32_t                               _pending_tx_skip_flags = 0;
+         uint64_t                               _blocks_from_pending_state = 0;
+         uint64_t                               _blocks_by_reapplying = 0;
+         validated_transaction_cache            _validated_tx;
+         evaluation_cache_stats                 _evaluation_cache_stats;
+
+         /**
+          * The balance objects adjust_balance() touched during the current transaction, the fee payer's
+          * core balance most of all.  Entries are checked against the object they name before use, so a
+          * stale one costs a lookup and nothing else.
+          */
+         struct touched_balance
+         {
+            account_id_type         owner;
+            asset_id_type           asset_type;
+            account_balance_id_type id;
+         };
+         static const size_t                    max_touched_balances = 8;
+         vector< touched_balance >              _touched_balances;
          fork_database                          _fork_db;
 
          /**
@@ -492,6 +549,10 @@ namespace graphene { namespace chain {
          vector<uint64_t>                  _witness_count_histogram_buffer;
          vector<uint64_t>                  _committee_count_histogram_buffer;
          uint64_t                          _total_voting_stake;
+         /// only set when node_property_object::incremental_vote_tally is enabled
+         unique_ptr<vote_tally_tracker>    _vote_tally_tracker;
+         proposal_authorization_cache      _proposal_authorizations;
+         authority_resolver                _authority_resolver;
 
          flat_map<uint32_t,block_id_type>  _checkpoints;
 
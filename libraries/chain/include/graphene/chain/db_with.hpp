@@ -68,7 +68,7 @@ struct skip_flags_restorer
  */
 struct pending_transactions_restorer
 {
-   pending_transactions_restorer( database& db, std::vector<processed_transaction>&& pending_transactions )
+   pending_transactions_restorer( database& db, pending_transaction_pool&& pending_transactions )
       : _db(db), _pending_transactions( std::move(pending_transactions) )
    {
       _db.clear_pending();
@@ -88,8 +88,11 @@ struct pending_transactions_restorer
          }
       }
       _db._popped_tx.clear();
-      for( const processed_transaction& tx : _pending_transactions )
+      // expired transactions can't be applied any more, drop them without trying
+      _pending_transactions.remove_expired( _db.head_block_time() );
+      for( const pending_transaction& entry : _pending_transactions.indices().get<by_sequence>() )
       {
+         const processed_transaction& tx = entry.trx;
          try
          {
             if( !_db.is_known_transaction( tx.id() ) ) {
@@ -109,7 +112,7 @@ struct pending_transactions_restorer
    }
 
    database& _db;
-   std::vector< processed_transaction > _pending_transactions;
+   pending_transaction_pool _pending_transactions;
 };
 
 /**
@@ -139,7 +142,7 @@ void with_skip_flags(
 template< typename Lambda >
 void without_pending_transactions(
    database& db,
-   std::vector<processed_transaction>&& pending_transactions,
+   pending_transaction_pool&& pending_transactions,
    Lambda callback )
 {
     pending_transactions_restorer restorer( db, std::move(pending_transactions) );
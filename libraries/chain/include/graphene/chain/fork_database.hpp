@@ -37,11 +37,19 @@ namespace graphene { namespace chain {
 
    struct fork_item
    {
-      fork_item( signed_block d )
+      fork_item( const signed_block& d )
+      :num(d.block_num()),id(d.id()),data( d ){}
+      fork_item( signed_block&& d )
       :num(d.block_num()),id(d.id()),data( std::move(d) ){}
 
       block_id_type previous_id()const { return data.previous; }
 
+      /**
+       * The block packed the way block_database stores it.  It is packed on first use and kept,
+       * so a block which is stored again after a fork switch is not packed twice.
+       */
+      const vector<char>&   packed_data()const;
+
       weak_ptr< fork_item > prev;
       uint32_t              num;    // initialized in ctor
       /**
@@ -51,6 +59,9 @@ namespace graphene { namespace chain {
       bool                  invalid = false;
       block_id_type         id;
       signed_block          data;
+
+   private:
+      mutable vector<char>  _packed_data;
    };
    typedef shared_ptr<fork_item> item_ptr;
 
@@ -86,6 +97,7 @@ namespace graphene { namespace chain {
           *  @return the new head block ( the longest fork )
           */
          shared_ptr<fork_item>            push_block(const signed_block& b);
+         shared_ptr<fork_item>            push_block(signed_block&& b);
          shared_ptr<fork_item>            head()const { return _head; }
          void                             pop_block();
 
@@ -111,6 +123,7 @@ namespace graphene { namespace chain {
          void set_max_size( uint32_t s );
 
       private:
+         shared_ptr<fork_item> _push_item(const item_ptr& item);
          /** @return a pointer to the newly pushed item */
          void _push_block(const item_ptr& b );
          void _push_next(const item_ptr& newly_inserted);
@@ -48,8 +48,10 @@ namespace graphene { namespace chain {
 
       game_object();
       game_object(const game_object& rhs);
+      game_object(game_object&& rhs);
       ~game_object();
       game_object& operator=(const game_object& rhs);
+      game_object& operator=(game_object&& rhs);
 
       void evaluate_move_operation(const database& db, const game_move_operation& op) const;
       void make_automatic_moves(database& db);
@@ -106,7 +108,6 @@ namespace graphene { namespace chain {
       // fc::raw::pack the contents hidden in the impl class
       std::ostringstream stream;
       game_obj.pack_impl(stream);
-      std::string stringified_stream(stream.str());
       fc::raw::pack(s, stream.str());
 
       return s;
@@ -25,7 +25,7 @@
 
 #include <graphene/chain/protocol/asset.hpp>
 #include <graphene/chain/protocol/types.hpp>
-#include <graphene/db/generic_index.hpp>
+#include <graphene/db/dense_index.hpp>
 #include <graphene/db/object.hpp>
 
 #include <boost/multi_index/composite_key.hpp>
@@ -95,7 +95,7 @@ typedef multi_index_container<
    >
 > limit_order_multi_index_type;
 
-typedef generic_index<limit_order_object, limit_order_multi_index_type> limit_order_index;
+typedef dense_index<limit_order_object, limit_order_multi_index_type> limit_order_index;
 
 /**
  * @class call_order_object
@@ -70,8 +70,10 @@ namespace graphene { namespace chain {
 
       match_object();
       match_object(const match_object& rhs);
+      match_object(match_object&& rhs);
       ~match_object();
       match_object& operator=(const match_object& rhs);
+      match_object& operator=(match_object&& rhs);
       
       match_state get_state() const;
 
@@ -104,6 +106,25 @@ namespace graphene { namespace chain {
    > match_object_multi_index_type;
    typedef generic_index<match_object, match_object_multi_index_type> match_index;
 
+   /**
+    * @brief Tracks the tournaments which had a match created or changed
+    *
+    * Whether a tournament can start new matches depends only on the state of its own matches, so
+    * database::update_tournaments only needs to re-check the tournaments collected here instead of
+    * every tournament in progress.  Undo also goes through modify(), so reverted matches are reported
+    * as well; a tournament being listed without need only costs a redundant check.
+    */
+   class tournament_match_change_index : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override{};
+         virtual void object_modified( const object& after  ) override;
+
+         flat_set<tournament_id_type> changed_tournaments;
+   };
+
    template<typename Stream>
    inline Stream& operator<<( Stream& s, const match_object& match_obj )
    { 
@@ -124,7 +145,6 @@ namespace graphene { namespace chain {
       // fc::raw::pack the contents hidden in the impl class
       std::ostringstream stream;
       match_obj.pack_impl(stream);
-      std::string stringified_stream(stream.str());
       fc::raw::pack(s, stream.str());
 
       return s;
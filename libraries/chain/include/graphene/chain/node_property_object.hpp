@@ -43,6 +43,20 @@ namespace graphene { namespace chain {
          ~node_property_object(){}
 
          uint32_t skip_flags = 0;
+         /// threads used to tally votes at maintenance time, 0 picks one per core for large account sets
+         uint32_t maintenance_threads = 0;
+         /// threads verifying the confidential transactions of a block, 0 picks one per core
+         uint32_t confidential_verification_threads = 0;
+         /// keep vote tallies up to date as balances and votes change instead of recounting every account
+         bool incremental_vote_tally = false;
+         /// recount every account anyway and compare with the incremental tallies
+         bool check_vote_tally = false;
+         /// produce blocks on top of the already applied pending transactions instead of applying them again
+         bool produce_from_pending_state = false;
+         /// most transactions kept pending for the next block, 0 for no limit
+         uint32_t max_pending_transactions = 0;
+         /// most packed bytes of transactions kept pending for the next block, 0 for no limit
+         uint64_t max_pending_transaction_bytes = 0;
          std::map< block_id_type, std::vector< fc::variant_object > > debug_updates;
    };
 } } // graphene::chain
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <graphene/chain/protocol/transaction.hpp>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/mem_fun.hpp>
+#include <boost/multi_index/composite_key.hpp>
+
+namespace graphene { namespace chain {
+   using boost::multi_index_container;
+   using namespace boost::multi_index;
+
+   /**
+    * A transaction waiting in the pending pool, with what the pool orders it by.
+    */
+   struct pending_transaction
+   {
+      pending_transaction( processed_transaction&& t, uint64_t seq, uint32_t size, uint64_t fee_rate )
+      :trx( std::move(t) ),id( trx.id() ),sequence( seq ),packed_size( size ),fee_per_kbyte( fee_rate ){}
+
+      time_point_sec expiration()const { return trx.expiration; }
+
+      processed_transaction trx;
+      transaction_id_type   id;
+      /** arrival order, which is also the order the transactions were applied in */
+      uint64_t              sequence;
+      uint32_t              packed_size;
+      /** core asset equivalent of the fees declared by the transaction per 1024 bytes */
+      uint64_t              fee_per_kbyte;
+   };
+
+   struct by_sequence;
+   struct by_trx_id;
+   struct by_expiration;
+   struct by_priority;
+   typedef multi_index_container<
+      pending_transaction,
+      indexed_by<
+         ordered_unique< tag<by_sequence>, member< pending_transaction, uint64_t, &pending_transaction::sequence > >,
+         hashed_unique< tag<by_trx_id>, member< pending_transaction, transaction_id_type, &pending_transaction::id >,
+                        std::hash<transaction_id_type> >,
+         ordered_non_unique< tag<by_expiration>, const_mem_fun< pending_transaction, time_point_sec, &pending_transaction::expiration > >,
+         /// lowest fee rate first, and the latest arrival first among equal fee rates
+         ordered_unique< tag<by_priority>,
+            composite_key< pending_transaction,
+               member< pending_transaction, uint64_t, &pending_transaction::fee_per_kbyte >,
+               member< pending_transaction, uint64_t, &pending_transaction::sequence >
+            >,
+            composite_key_compare< std::less<uint64_t>, std::greater<uint64_t> >
+         >
+      >
+   > pending_transaction_multi_index_type;
+
+   /**
+    *  @class pending_transaction_pool
+    *  @brief the transactions applied on top of the head block that wait to be included in a block
+    *
+    *  The pool may be bounded by a number of transactions and a number of packed bytes, where a limit
+    *  of 0 means unbounded.  When it is full, a transaction gets in only by paying a higher fee rate
+    *  than the transactions it evicts, which are evicted before it is applied.
+    */
+   class pending_transaction_pool
+   {
+      public:
+         typedef pending_transaction_multi_index_type index_type;
+
+         const index_type& indices()const { return _index; }
+         bool     empty()const { return _index.empty(); }
+         size_t   size()const { return _index.size(); }
+         /** total packed size of the transactions in the pool */
+         uint64_t packed_size()const { return _packed_size; }
+
+         /**
+          * @return whether a transaction with this size and fee rate fits within the limits, counting the
+          * transactions with a lower fee rate it would evict
+          */
+         bool can_accept( uint32_t packed_size, uint64_t fee_per_kbyte, uint32_t max_count, uint64_t max_bytes )const;
+         void insert( processed_transaction&& trx, uint32_t packed_size, uint64_t fee_per_kbyte );
+         /**
+          * removes the lowest priority transactions until a transaction of packed_size fits within the limits,
+          * @return how many
+          */
+         size_t evict_for( uint32_t packed_size, uint32_t max_count, uint64_t max_bytes );
+         /** removes the transactions that expire before now, @return how many */
+         size_t remove_expired( time_point_sec now );
+         void clear();
+
+      private:
+         index_type _index;
+         uint64_t   _next_sequence = 0;
+         uint64_t   _packed_size = 0;
+   };
+
+   struct validated_transaction
+   {
+      transaction_id_type id;
+      time_point_sec      expiration;
+   };
+
+   typedef multi_index_container<
+      validated_transaction,
+      indexed_by<
+         hashed_unique< tag<by_trx_id>, member< validated_transaction, transaction_id_type, &validated_transaction::id >,
+                        std::hash<transaction_id_type> >,
+         ordered_non_unique< tag<by_expiration>, member< validated_transaction, time_point_sec, &validated_transaction::expiration > >
+      >
+   > validated_transaction_multi_index_type;
+
+   /**
+    *  @class validated_transaction_cache
+    *  @brief the ids of the transactions that passed transaction::validate()
+    *
+    *  Those checks only depend on the transaction bytes the id is a hash of, so a transaction seen again while
+    *  pending, while generating a block or in a block doesn't need them again.  Entries are kept until the
+    *  transaction expires, and the earliest expiring ones are dropped beyond max_size.
+    */
+   class validated_transaction_cache
+   {
+      public:
+         static const size_t max_size = 1024 * 1024;
+
+         /** runs trx.validate() unless a transaction with this id already passed it */
+         void validate( const transaction& trx, const transaction_id_type& id );
+         bool contains( const transaction_id_type& id )const { return _index.find( id ) != _index.end(); }
+         /** records a transaction that passed trx.validate() somewhere else, such as on a worker thread */
+         void record( const transaction_id_type& id, time_point_sec expiration );
+         /** removes the transactions that expire before now, @return how many */
+         size_t remove_expired( time_point_sec now );
+
+         size_t   size()const { return _index.size(); }
+         uint64_t validations_performed()const { return _performed; }
+         uint64_t validations_avoided()const { return _avoided; }
+
+      private:
+         validated_transaction_multi_index_type _index;
+         uint64_t _performed = 0;
+         uint64_t _avoided = 0;
+   };
+} }
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <graphene/chain/protocol/authority.hpp>
+#include <graphene/chain/protocol/types.hpp>
+#include <graphene/db/index.hpp>
+
+namespace graphene { namespace chain {
+   class database;
+   class proposal_object;
+
+   /**
+    * @brief Follows how far the approvals of each proposal get towards its required authorities
+    *
+    * For every proposal looked at, the authorities authority verification may consult are fetched once:
+    * those of the required accounts and, down to the maximum authority depth, the active authorities of
+    * the accounts they name.  Approvals are propagated through them as they are added, so telling whether
+    * the required authorities can be satisfied at all only costs the approvals added since the last look.
+    *
+    * This is a necessary condition only: everything verify_authority() counts as satisfied is satisfied
+    * here as well.  proposal_object::is_authorized_to_execute still runs the full verification once it
+    * holds, so its verdicts do not change.
+    *
+    * The entry of a proposal is built again when approvals were removed, when one of the fetched accounts,
+    * the maximum authority depth or the side of HARDFORK_ADDRESS_AUTH_TIME changed, and when the proposal
+    * is removed or inserted.  Changes are
+    * reported through @ref proposal_authorization_index on the proposal and account indexes, undo
+    * included.
+    */
+   class proposal_authorization_cache
+   {
+      public:
+         /// false if the approvals of @p proposal cannot satisfy its required authorities yet
+         bool may_be_authorized( const proposal_object& proposal, const database& db );
+
+         void object_inserted( const object& obj );
+         void object_removed( const object& obj );
+         void object_modified( const object& after );
+
+         /// forgets all proposals
+         void clear();
+
+         /// how often may_be_authorized() let the full verification run, and how often it saved it
+         uint64_t verifications_performed()const { return _verifications_performed; }
+         uint64_t verifications_avoided()const { return _verifications_avoided; }
+
+      private:
+         struct authority_node
+         {
+            uint64_t                  weight = 0;
+            uint32_t                  weight_threshold = 0;
+            bool                      satisfied = false;
+            /// the account this is the active authority of, unset for owner authorities
+            optional<account_id_type> account;
+         };
+
+         /// the authority nodes naming a key, address or account, with the weight they give it
+         typedef vector< pair<uint32_t, weight_type> > edge_list;
+
+         struct entry
+         {
+            uint32_t                              max_authority_depth = 0;
+            /// whether the entry was built before HARDFORK_ADDRESS_AUTH_TIME, when every address counts as signed
+            bool                                  unmatched_addresses_signed = false;
+            /// set when the proposal needs authorities other than those of accounts, left to the full verification
+            bool                                  verify_always = false;
+            flat_set<account_id_type>             required_active;
+            flat_set<account_id_type>             required_owner;
+            vector<authority_node>                nodes;
+            flat_map<account_id_type, uint32_t>   owner_nodes;
+            map<public_key_type, edge_list>       key_edges;
+            map<address, edge_list>               address_edges;
+            map<account_id_type, edge_list>       account_edges;
+            /// the accounts whose authorities were fetched, or looked for
+            flat_set<account_id_type>             fetched_accounts;
+            /// accounts approving or with a satisfied active authority
+            set<account_id_type>                  satisfied_accounts;
+            set<address>                          approved_addresses;
+
+            /// the approvals propagated so far
+            flat_set<account_id_type>             active_approvals;
+            flat_set<account_id_type>             owner_approvals;
+            flat_set<public_key_type>             key_approvals;
+         };
+
+         void build_entry( entry& e, const proposal_object& proposal, const database& db );
+         void erase_entry( proposal_id_type proposal );
+         void account_changed( account_id_type account );
+
+         void approve_account( entry& e, account_id_type account );
+         void approve_key( entry& e, const public_key_type& key );
+         void add_weight( entry& e, uint32_t node, weight_type weight );
+
+         map<proposal_id_type, entry>                        _entries;
+         /// the proposals whose entries fetched an account
+         map<account_id_type, flat_set<proposal_id_type>>    _proposals_by_account;
+         uint64_t                                            _verifications_performed = 0;
+         uint64_t                                            _verifications_avoided = 0;
+   };
+
+   /**
+    * @brief Reports changes to an index to a @ref proposal_authorization_cache
+    */
+   class proposal_authorization_index : public secondary_index
+   {
+      public:
+         proposal_authorization_index( proposal_authorization_cache& cache ) : _cache(cache) {}
+
+         virtual void object_inserted( const object& obj ) override { _cache.object_inserted( obj ); }
+         virtual void object_removed( const object& obj ) override { _cache.object_removed( obj ); }
+         virtual void object_modified( const object& after ) override { _cache.object_modified( after ); }
+
+      private:
+         proposal_authorization_cache& _cache;
+   };
+
+} } // graphene::chain
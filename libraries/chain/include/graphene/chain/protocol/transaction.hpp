@@ -64,6 +64,8 @@ namespace graphene { namespace chain {
     */
    struct transaction
    {
+      virtual ~transaction() = default;
+
       /**
        * Least significant 16 bits from the reference block number. If @ref relative_expiration is zero, this field
        * must be zero as well.
@@ -86,11 +88,15 @@ namespace graphene { namespace chain {
 
       /// Calculate the digest for a transaction
       digest_type         digest()const;
-      transaction_id_type id()const;
+      virtual transaction_id_type id()const;
       void                validate() const;
       /// Calculate the digest used for signature validation
       digest_type         sig_digest( const chain_id_type& chain_id )const;
 
+      /// id() and sig_digest() of a transaction already packed into @p packed, sparing packing it again
+      static transaction_id_type id_from_packed( const vector<char>& packed );
+      static digest_type         sig_digest_from_packed( const chain_id_type& chain_id, const vector<char>& packed );
+
       void set_expiration( fc::time_point_sec expiration_time );
       void set_reference_block( const block_id_type& reference_block );
 
@@ -148,7 +154,8 @@ namespace graphene { namespace chain {
          const chain_id_type& chain_id,
          const std::function<const authority*(account_id_type)>& get_active,
          const std::function<const authority*(account_id_type)>& get_owner,
-         uint32_t max_recursion = GRAPHENE_MAX_SIG_CHECK_DEPTH )const;
+         uint32_t max_recursion = GRAPHENE_MAX_SIG_CHECK_DEPTH,
+         bool unmatched_addresses_signed = false )const;
 
       /**
        * This is a slower replacement for get_required_signatures()
@@ -166,6 +173,8 @@ namespace graphene { namespace chain {
          ) const;
 
       flat_set<public_key_type> get_signature_keys( const chain_id_type& chain_id )const;
+      /// get_signature_keys() for the signature digest @p sig_digest computed already
+      flat_set<public_key_type> get_signature_keys_from_digest( const digest_type& sig_digest )const;
 
       vector<signature_type> signatures;
 
@@ -173,13 +182,19 @@ namespace graphene { namespace chain {
       void clear() { operations.clear(); signatures.clear(); }
    };
 
+   /**
+    * Throws unless @p sigs and the approvals satisfy the authorities @p ops require.  Before
+    * HARDFORK_ADDRESS_AUTH_TIME an address in an authority that matched none of the keys counted as signed,
+    * callers checking transactions of the chain pass @p unmatched_addresses_signed accordingly.
+    */
    void verify_authority( const vector<operation>& ops, const flat_set<public_key_type>& sigs,
                           const std::function<const authority*(account_id_type)>& get_active,
                           const std::function<const authority*(account_id_type)>& get_owner,
                           uint32_t max_recursion = GRAPHENE_MAX_SIG_CHECK_DEPTH,
                           bool allow_committe = false,
                           const flat_set<account_id_type>& active_aprovals = flat_set<account_id_type>(),
-                          const flat_set<account_id_type>& owner_approvals = flat_set<account_id_type>());
+                          const flat_set<account_id_type>& owner_approvals = flat_set<account_id_type>(),
+                          bool unmatched_addresses_signed = false );
 
    /**
     *  @brief captures the result of evaluating the operations contained in the transaction
@@ -202,6 +217,16 @@ namespace graphene { namespace chain {
       vector<operation_result> operation_results;
 
       digest_type merkle_digest()const;
+
+      /**
+       * Processed transactions are the ones carried by blocks, whose ids are looked up over and over
+       * while a block is applied, so the id is computed once and remembered.  The transaction must
+       * not be modified after its id has been asked for.
+       */
+      virtual transaction_id_type id()const override;
+
+   private:
+      mutable transaction_id_type _trx_id;
    };
 
    /// @} transactions group
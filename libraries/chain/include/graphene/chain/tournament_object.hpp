@@ -64,8 +64,10 @@ namespace graphene { namespace chain {
 
       tournament_object();
       tournament_object(const tournament_object& rhs);
+      tournament_object(tournament_object&& rhs);
       ~tournament_object();
       tournament_object& operator=(const tournament_object& rhs);
+      tournament_object& operator=(tournament_object&& rhs);
       
       tournament_id_type get_id() const { return id; };
       /// the account that created this tournament
@@ -156,7 +158,6 @@ namespace graphene { namespace chain {
    template<typename Stream>
    inline Stream& operator<<( Stream& s, const tournament_object& tournament_obj )
    { 
-      fc_elog(fc::logger::get("tournament"), "In tournament_obj to_raw");
       // pack all fields exposed in the header in the usual way
       // instead of calling the derived pack, just serialize the one field in the base class
       //   fc::raw::pack<Stream, const graphene::db::abstract_object<tournament_object> >(s, tournament_obj);
@@ -172,9 +173,6 @@ namespace graphene { namespace chain {
       // fc::raw::pack the contents hidden in the impl class
       std::ostringstream stream;
       tournament_obj.pack_impl(stream);
-      std::string stringified_stream(stream.str());
-      fc_elog(fc::logger::get("tournament"), "Serialized state ${state} to bytes ${bytes}", 
-              ("state", tournament_obj.get_state())("bytes", fc::to_hex(stringified_stream.c_str(), stringified_stream.size())));
       fc::raw::pack(s, stream.str());
 
       return s;
@@ -182,7 +180,6 @@ namespace graphene { namespace chain {
    template<typename Stream>
    inline Stream& operator>>( Stream& s, tournament_object& tournament_obj )
    { 
-      fc_elog(fc::logger::get("tournament"), "In tournament_obj from_raw");
       // unpack all fields exposed in the header in the usual way
       //fc::raw::unpack<Stream, graphene::db::abstract_object<tournament_object> >(s, tournament_obj);
       fc::raw::unpack(s, tournament_obj.id);
@@ -199,8 +196,6 @@ namespace graphene { namespace chain {
       fc::raw::unpack(s, stringified_stream);
       std::istringstream stream(stringified_stream);
       tournament_obj.unpack_impl(stream);
-      fc_elog(fc::logger::get("tournament"), "Deserialized state ${state} from bytes ${bytes}", 
-              ("state", tournament_obj.get_state())("bytes", fc::to_hex(stringified_stream.c_str(), stringified_stream.size())));
       
       return s;
    }
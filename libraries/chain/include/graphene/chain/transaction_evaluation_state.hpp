@@ -28,6 +28,13 @@ namespace graphene { namespace chain {
    class database;
    struct signed_transaction;
 
+   /** how many objects the evaluators resolved through the object cache, and how many of those it already had */
+   struct evaluation_cache_stats
+   {
+      uint64_t lookups = 0;
+      uint64_t hits = 0;
+   };
+
    /**
     *  Place holder for state tracked while processing a transaction. This class provides helper methods that are
     *  common to many different operations and also tracks which keys have signed the transaction
@@ -40,6 +47,21 @@ namespace graphene { namespace chain {
 
 
          database& db()const { assert( _db ); return *_db; }
+
+         /**
+          *  The objects fee payment and the evaluators resolve over and over, cached for the duration of the
+          *  transaction.  Accounts, assets and their statistics and dynamic data are only ever removed by undoing
+          *  the session they were created in, and the sessions opened while a transaction is applied, such as
+          *  the one for executing a proposal, come with their own evaluation state.
+          */
+         ///@{
+         const account_object&            get_account( account_id_type id );
+         const account_statistics_object& get_account_statistics( const account_object& account );
+         const asset_object&              get_asset( asset_id_type id );
+         const asset_dynamic_data_object& get_asset_dynamic_data( const asset_object& asset );
+         const global_property_object&    get_global_properties();
+         ///@}
+
          vector<operation_result> operation_results;
 
          const signed_transaction*        _trx = nullptr;
@@ -47,5 +69,13 @@ namespace graphene { namespace chain {
          bool                             _is_proposed_trx = false;
          bool                             skip_fee = false;
          bool                             skip_fee_schedule_check = false;
+         evaluation_cache_stats           cache_stats;
+
+      private:
+         vector< const account_object* >            _accounts;
+         vector< const account_statistics_object* > _account_statistics;
+         vector< const asset_object* >              _assets;
+         vector< const asset_dynamic_data_object* > _asset_dynamic_data;
+         const global_property_object*              _global_properties = nullptr;
    };
 } } // namespace graphene::chain
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <graphene/chain/protocol/types.hpp>
+#include <graphene/db/index.hpp>
+
+namespace graphene { namespace chain {
+   class database;
+   class account_object;
+   class global_property_object;
+
+   /**
+    * @brief The vote tallies that database::perform_chain_maintenance works with
+    */
+   struct vote_tally_buffers
+   {
+      vector<uint64_t> vote_tally;
+      vector<uint64_t> witness_count_histogram;
+      vector<uint64_t> committee_count_histogram;
+      uint64_t         total_voting_stake = 0;
+
+      bool operator == ( const vote_tally_buffers& other )const
+      {
+         return vote_tally == other.vote_tally
+             && witness_count_histogram == other.witness_count_histogram
+             && committee_count_histogram == other.committee_count_histogram
+             && total_voting_stake == other.total_voting_stake;
+      }
+   };
+
+   /**
+    * @brief Keeps running vote tallies up to date between maintenance intervals
+    *
+    * The voting stake of an account is its core balance, its core vesting balances, the balance of
+    * its cashback vesting balance and its core in open orders.  The cashback balance is also one of
+    * the account's vesting balances, so it counts twice, exactly as in the full tally.  Every change
+    * to one of these objects or to an account is reported through a @ref vote_tally_index and
+    * applied to the tallies as a delta.  Undo reports its changes the same way, so the tallies follow
+    * popped blocks as well.
+    *
+    * Non-member votes are always counted; the full tally has to be used when the chain parameters
+    * say otherwise.
+    */
+   class vote_tally_tracker
+   {
+      public:
+         vote_tally_tracker( const database& db ) : _db(db) {}
+
+         void object_inserted( const object& obj );
+         void object_removed( const object& obj );
+         void about_to_modify( const object& before );
+         void object_modified( const object& after );
+
+         /// forgets all objects counted so far
+         void clear();
+
+         /// the tallies as the full tally would compute them under the given parameters
+         void get_tally( const global_property_object& gpo, vote_tally_buffers& tally )const;
+
+         /// adds @p delta of voting stake held by @p account to @p tally
+         void add_stake_to_tally( account_id_type account, share_type delta,
+                                  const global_property_object& gpo, vote_tally_buffers& tally )const;
+
+      private:
+         struct account_entry
+         {
+            /// stake held by the account itself
+            share_type                        voting_stake;
+            /// stake of all accounts whose opinions are specified by this account
+            share_type                        proxied_stake;
+            /// the account specifying this account's opinions, valid while counted
+            account_id_type                   opinion_account;
+            optional<vesting_balance_id_type> cashback_vb;
+            bool                              counted = false;
+         };
+
+         account_entry& get_entry( account_id_type account );
+         /// the account and voting stake a balance, vesting balance or statistics object contributes
+         std::pair<account_id_type, share_type> get_stake( const object& obj )const;
+
+         void adjust_voting_stake( account_id_type account, share_type delta );
+         void adjust_proxied_stake( account_id_type account, share_type delta );
+         void apply_opinions( const account_object& opinion_account, share_type delta );
+         void add_account( const account_object& a );
+         void remove_account( const account_object& a );
+
+         const database&                      _db;
+         /// indexed by account instance
+         vector<account_entry>                _accounts;
+         /// indexed by vote_id_type::instance()
+         vector<share_type>                   _vote_tally;
+         /// voting stake by the number of witnesses (committee members) voted for
+         flat_map<uint16_t, share_type>       _witness_count_stake;
+         flat_map<uint16_t, share_type>       _committee_count_stake;
+         share_type                           _total_voting_stake;
+
+         /// stake of the object being modified, taken in about_to_modify()
+         std::pair<account_id_type, share_type> _stake_before;
+   };
+
+   /**
+    * @brief Reports changes to an index to a @ref vote_tally_tracker
+    */
+   class vote_tally_index : public secondary_index
+   {
+      public:
+         vote_tally_index( vote_tally_tracker& tracker ) : _tracker(tracker) {}
+
+         virtual void object_inserted( const object& obj ) override { _tracker.object_inserted( obj ); }
+         virtual void object_removed( const object& obj ) override { _tracker.object_removed( obj ); }
+         virtual void about_to_modify( const object& before ) override { _tracker.about_to_modify( before ); }
+         virtual void object_modified( const object& after ) override { _tracker.object_modified( after ); }
+
+      private:
+         vote_tally_tracker& _tracker;
+   };
+
+} } // graphene::chain
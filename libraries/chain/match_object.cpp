@@ -283,6 +283,44 @@ namespace graphene { namespace chain {
       return *this;
    }
 
+   // moving hands the state machine over instead of allocating and copying a new one; undo
+   // restores objects with move_from(), and create() moves the new object into the index
+   match_object::match_object(match_object&& rhs) :
+      graphene::db::abstract_object<match_object>(rhs),
+      tournament_id(rhs.tournament_id),
+      players(std::move(rhs.players)),
+      games(std::move(rhs.games)),
+      game_winners(std::move(rhs.game_winners)),
+      number_of_wins(std::move(rhs.number_of_wins)),
+      number_of_ties(rhs.number_of_ties),
+      match_winners(std::move(rhs.match_winners)),
+      start_time(rhs.start_time),
+      end_time(std::move(rhs.end_time)),
+      my(std::move(rhs.my))
+   {
+      my->state_machine.match_obj = this;
+   }
+
+   match_object& match_object::operator=(match_object&& rhs)
+   {
+      id = rhs.id;
+      tournament_id = rhs.tournament_id;
+      players = std::move(rhs.players);
+      games = std::move(rhs.games);
+      game_winners = std::move(rhs.game_winners);
+      number_of_wins = std::move(rhs.number_of_wins);
+      number_of_ties = rhs.number_of_ties;
+      match_winners = std::move(rhs.match_winners);
+      start_time = rhs.start_time;
+      end_time = std::move(rhs.end_time);
+      std::swap(my, rhs.my);
+      my->state_machine.match_obj = this;
+      if (rhs.my)
+         rhs.my->state_machine.match_obj = &rhs;
+
+      return *this;
+   }
+
    match_object::~match_object()
    {
    }
@@ -360,14 +398,30 @@ namespace graphene { namespace chain {
    }
 #endif
 
+   void tournament_match_change_index::object_inserted(const object& obj)
+   {
+      assert( dynamic_cast<const match_object*>(&obj) ); // for debug only
+      changed_tournaments.insert(static_cast<const match_object&>(obj).tournament_id);
+   }
+
+   void tournament_match_change_index::object_removed(const object& obj)
+   {
+      assert( dynamic_cast<const match_object*>(&obj) ); // for debug only
+      changed_tournaments.insert(static_cast<const match_object&>(obj).tournament_id);
+   }
+
+   void tournament_match_change_index::object_modified(const object& after)
+   {
+      assert( dynamic_cast<const match_object*>(&after) ); // for debug only
+      changed_tournaments.insert(static_cast<const match_object&>(after).tournament_id);
+   }
+
 } } // graphene::chain
 
 namespace fc { 
    // Manually reflect match_object to variant to properly reflect "state"
    void to_variant(const graphene::chain::match_object& match_obj, fc::variant& v)
    { try {
-      fc_elog(fc::logger::get("tournament"), "In match_obj to_variant");
-      elog("In match_obj to_variant");
       fc::mutable_variant_object o;
       o("id", match_obj.id)
        ("tournament_id", match_obj.tournament_id)
@@ -387,7 +441,6 @@ namespace fc {
    // Manually reflect match_object to variant to properly reflect "state"
    void from_variant(const fc::variant& v, graphene::chain::match_object& match_obj)
    { try {
-      fc_elog(fc::logger::get("tournament"), "In match_obj from_variant");
       match_obj.id = v["id"].as<graphene::chain::match_id_type>();
       match_obj.tournament_id = v["tournament_id"].as<graphene::chain::tournament_id_type>();
       match_obj.players = v["players"].as<std::vector<graphene::chain::account_id_type> >();
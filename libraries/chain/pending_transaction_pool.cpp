@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/pending_transaction_pool.hpp>
+
+namespace graphene { namespace chain {
+
+bool pending_transaction_pool::can_accept( uint32_t packed_size, uint64_t fee_per_kbyte,
+                                          uint32_t max_count, uint64_t max_bytes )const
+{
+   if( max_bytes > 0 && packed_size > max_bytes )
+      return false;
+
+   size_t count = _index.size() + 1;
+   uint64_t bytes = _packed_size + packed_size;
+   const auto& by_fee_rate = _index.get<by_priority>();
+   auto itr = by_fee_rate.begin();
+   while( (max_count > 0 && count > max_count) || (max_bytes > 0 && bytes > max_bytes) )
+   {
+      if( itr == by_fee_rate.end() || itr->fee_per_kbyte >= fee_per_kbyte )
+         return false;
+      --count;
+      bytes -= itr->packed_size;
+      ++itr;
+   }
+   return true;
+}
+
+void pending_transaction_pool::insert( processed_transaction&& trx, uint32_t packed_size, uint64_t fee_per_kbyte )
+{
+   auto result = _index.emplace( std::move(trx), _next_sequence++, packed_size, fee_per_kbyte );
+   FC_ASSERT( result.second, "transaction is already pending" );
+   _packed_size += packed_size;
+}
+
+size_t pending_transaction_pool::evict_for( uint32_t packed_size, uint32_t max_count, uint64_t max_bytes )
+{
+   size_t evicted = 0;
+   auto& by_fee_rate = _index.get<by_priority>();
+   while( !_index.empty() &&
+          ( (max_count > 0 && _index.size() + 1 > max_count) || (max_bytes > 0 && _packed_size + packed_size > max_bytes) ) )
+   {
+      _packed_size -= by_fee_rate.begin()->packed_size;
+      by_fee_rate.erase( by_fee_rate.begin() );
+      ++evicted;
+   }
+   return evicted;
+}
+
+size_t pending_transaction_pool::remove_expired( time_point_sec now )
+{
+   auto& by_exp = _index.get<by_expiration>();
+   auto end = by_exp.lower_bound( now );
+   size_t removed = 0;
+   for( auto itr = by_exp.begin(); itr != end; ++itr )
+   {
+      _packed_size -= itr->packed_size;
+      ++removed;
+   }
+   by_exp.erase( by_exp.begin(), end );
+   return removed;
+}
+
+void pending_transaction_pool::clear()
+{
+   _index.clear();
+   _packed_size = 0;
+}
+
+void validated_transaction_cache::validate( const transaction& trx, const transaction_id_type& id )
+{
+   if( _index.find( id ) != _index.end() )
+   {
+      ++_avoided;
+      return;
+   }
+   trx.validate();
+   record( id, trx.expiration );
+}
+
+void validated_transaction_cache::record( const transaction_id_type& id, time_point_sec expiration )
+{
+   if( !_index.insert( validated_transaction{ id, expiration } ).second )
+      return;
+   ++_performed;
+   if( _index.size() > max_size )
+   {
+      auto& by_exp = _index.get<by_expiration>();
+      by_exp.erase( by_exp.begin() );
+   }
+}
+
+size_t validated_transaction_cache::remove_expired( time_point_sec now )
+{
+   auto& by_exp = _index.get<by_expiration>();
+   auto end = by_exp.lower_bound( now );
+   size_t removed = std::distance( by_exp.begin(), end );
+   by_exp.erase( by_exp.begin(), end );
+   return removed;
+}
+
+} } // graphene::chain
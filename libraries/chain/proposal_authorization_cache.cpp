@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/proposal_authorization_cache.hpp>
+
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/global_property_object.hpp>
+#include <graphene/chain/hardfork.hpp>
+#include <graphene/chain/proposal_object.hpp>
+#include <graphene/chain/pts_address.hpp>
+
+#include <deque>
+
+namespace graphene { namespace chain {
+
+bool proposal_authorization_cache::may_be_authorized( const proposal_object& proposal, const database& db )
+{
+   const uint32_t max_authority_depth = db.get_global_properties().parameters.max_authority_depth;
+   const bool unmatched_addresses_signed = db.head_block_time() < HARDFORK_ADDRESS_AUTH_TIME;
+   auto itr = _entries.find( proposal.id );
+   // removed approvals cannot be taken back out of the propagated weights, so start over then
+   if( itr == _entries.end() || itr->second.max_authority_depth != max_authority_depth
+       || itr->second.unmatched_addresses_signed != unmatched_addresses_signed
+       || !std::includes( proposal.available_active_approvals.begin(), proposal.available_active_approvals.end(),
+                          itr->second.active_approvals.begin(), itr->second.active_approvals.end() )
+       || !std::includes( proposal.available_owner_approvals.begin(), proposal.available_owner_approvals.end(),
+                          itr->second.owner_approvals.begin(), itr->second.owner_approvals.end() )
+       || !std::includes( proposal.available_key_approvals.begin(), proposal.available_key_approvals.end(),
+                          itr->second.key_approvals.begin(), itr->second.key_approvals.end() ) )
+   {
+      erase_entry( proposal.id );
+      itr = _entries.emplace( proposal.id, entry() ).first;
+      build_entry( itr->second, proposal, db );
+   }
+   entry& e = itr->second;
+
+   for( account_id_type id : proposal.available_active_approvals )
+      if( e.active_approvals.insert( id ).second )
+         approve_account( e, id );
+   for( account_id_type id : proposal.available_owner_approvals )
+      if( e.owner_approvals.insert( id ).second )
+         approve_account( e, id );
+   for( const public_key_type& key : proposal.available_key_approvals )
+      if( e.key_approvals.insert( key ).second )
+         approve_key( e, key );
+
+   auto owner_satisfied = [&e]( account_id_type id ) {
+      auto node = e.owner_nodes.find( id );
+      return node != e.owner_nodes.end() && e.nodes[node->second].satisfied;
+   };
+
+   // the same requirements verify_authority() checks at the top level
+   bool satisfiable = true;
+   if( !e.verify_always )
+   {
+      for( account_id_type id : e.required_active )
+         if( e.satisfied_accounts.find( id ) == e.satisfied_accounts.end() && !owner_satisfied( id ) )
+            satisfiable = false;
+      for( account_id_type id : e.required_owner )
+         if( e.owner_approvals.find( id ) == e.owner_approvals.end() && !owner_satisfied( id ) )
+            satisfiable = false;
+   }
+
+   if( satisfiable )
+      ++_verifications_performed;
+   else
+      ++_verifications_avoided;
+   return satisfiable;
+}
+
+void proposal_authorization_cache::build_entry( entry& e, const proposal_object& proposal, const database& db )
+{
+   e.max_authority_depth = db.get_global_properties().parameters.max_authority_depth;
+   e.unmatched_addresses_signed = db.head_block_time() < HARDFORK_ADDRESS_AUTH_TIME;
+   vector<authority> other;
+   for( const auto& op : proposal.proposed_transaction.operations )
+      operation_get_required_authorities( op, e.required_active, e.required_owner, other );
+   e.verify_always = !other.empty();
+
+   // breadth first, so that every account is expanded at the smallest depth it is named at
+   std::deque< pair<account_id_type, uint32_t> > to_fetch;
+   auto add_node = [&]( const authority& auth, optional<account_id_type> account, uint32_t depth ) -> uint32_t {
+      const uint32_t node = e.nodes.size();
+      authority_node n;
+      n.weight_threshold = auth.weight_threshold;
+      n.account = account;
+      e.nodes.push_back( n );
+      for( const auto& k : auth.key_auths )
+         e.key_edges[k.first].emplace_back( node, k.second );
+      for( const auto& a : auth.address_auths )
+         e.address_edges[a.first].emplace_back( node, a.second );
+      for( const auto& a : auth.account_auths )
+      {
+         e.account_edges[a.first].emplace_back( node, a.second );
+         if( depth < e.max_authority_depth && e.fetched_accounts.insert( a.first ).second )
+            to_fetch.emplace_back( a.first, depth + 1 );
+      }
+      return node;
+   };
+
+   flat_set<account_id_type> required_accounts = e.required_active;
+   required_accounts.insert( e.required_owner.begin(), e.required_owner.end() );
+   for( account_id_type id : required_accounts )
+   {
+      e.fetched_accounts.insert( id );
+      to_fetch.emplace_back( id, 0 );
+   }
+   // owner authorities are only consulted for the required accounts themselves
+   for( account_id_type id : required_accounts )
+   {
+      const account_object* account = db.find( id );
+      if( account != nullptr )
+         e.owner_nodes[id] = add_node( account->owner, optional<account_id_type>(), 0 );
+   }
+   while( !to_fetch.empty() )
+   {
+      const account_id_type id = to_fetch.front().first;
+      const uint32_t depth = to_fetch.front().second;
+      to_fetch.pop_front();
+      const account_object* account = db.find( id );
+      if( account != nullptr )
+         add_node( account->active, id, depth );
+   }
+
+   for( account_id_type id : e.fetched_accounts )
+      _proposals_by_account[id].insert( proposal.id );
+
+   // sign_state approves the temp account up front, at any depth
+   approve_account( e, GRAPHENE_TEMP_ACCOUNT );
+   // before the hardfork an address is signed whether a key matches it or not
+   if( e.unmatched_addresses_signed )
+      for( const auto& a : e.address_edges )
+      {
+         e.approved_addresses.insert( a.first );
+         for( const auto& edge : a.second )
+            add_weight( e, edge.first, edge.second );
+      }
+   // authorities with a zero threshold hold without any approval
+   for( uint32_t node = 0; node < e.nodes.size(); ++node )
+      add_weight( e, node, 0 );
+}
+
+void proposal_authorization_cache::erase_entry( proposal_id_type proposal )
+{
+   auto itr = _entries.find( proposal );
+   if( itr == _entries.end() )
+      return;
+   for( account_id_type id : itr->second.fetched_accounts )
+   {
+      auto proposals = _proposals_by_account.find( id );
+      if( proposals == _proposals_by_account.end() )
+         continue;
+      proposals->second.erase( proposal );
+      if( proposals->second.empty() )
+         _proposals_by_account.erase( proposals );
+   }
+   _entries.erase( itr );
+}
+
+void proposal_authorization_cache::account_changed( account_id_type account )
+{
+   auto itr = _proposals_by_account.find( account );
+   if( itr == _proposals_by_account.end() )
+      return;
+   const flat_set<proposal_id_type> proposals = itr->second;
+   for( proposal_id_type proposal : proposals )
+      erase_entry( proposal );
+}
+
+void proposal_authorization_cache::approve_account( entry& e, account_id_type account )
+{
+   if( !e.satisfied_accounts.insert( account ).second )
+      return;
+   auto itr = e.account_edges.find( account );
+   if( itr != e.account_edges.end() )
+      for( const auto& edge : itr->second )
+         add_weight( e, edge.first, edge.second );
+}
+
+void proposal_authorization_cache::approve_key( entry& e, const public_key_type& key )
+{
+   auto itr = e.key_edges.find( key );
+   if( itr != e.key_edges.end() )
+      for( const auto& edge : itr->second )
+         add_weight( e, edge.first, edge.second );
+
+   if( e.address_edges.empty() )
+      return;
+   // the addresses a key signs for, as in sign_state::signed_by()
+   const address addresses[] = { address( pts_address( key, false, 56 ) ), address( pts_address( key, true, 56 ) ),
+                                 address( pts_address( key, false, 0 ) ), address( pts_address( key, true, 0 ) ),
+                                 address( key ) };
+   for( const address& a : addresses )
+   {
+      auto aitr = e.address_edges.find( a );
+      if( aitr != e.address_edges.end() && e.approved_addresses.insert( a ).second )
+         for( const auto& edge : aitr->second )
+            add_weight( e, edge.first, edge.second );
+   }
+}
+
+void proposal_authorization_cache::add_weight( entry& e, uint32_t node, weight_type weight )
+{
+   authority_node& n = e.nodes[node];
+   if( n.satisfied )
+      return;
+   n.weight += weight;
+   if( n.weight < n.weight_threshold )
+      return;
+   n.satisfied = true;
+   if( n.account.valid() )
+      approve_account( e, *n.account );
+}
+
+void proposal_authorization_cache::object_inserted( const object& obj )
+{
+   // an undone proposal's id is handed out again
+   if( obj.id.is<proposal_id_type>() )
+      erase_entry( obj.id );
+   else
+      account_changed( obj.id );
+}
+
+void proposal_authorization_cache::object_removed( const object& obj )
+{
+   if( obj.id.is<proposal_id_type>() )
+      erase_entry( obj.id );
+   else
+      account_changed( obj.id );
+}
+
+void proposal_authorization_cache::object_modified( const object& after )
+{
+   // proposals only change their approvals, which may_be_authorized() compares itself
+   if( !after.id.is<proposal_id_type>() )
+      account_changed( after.id );
+}
+
+void proposal_authorization_cache::clear()
+{
+   _entries.clear();
+   _proposals_by_account.clear();
+}
+
+} } // graphene::chain
@@ -24,11 +24,16 @@
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/account_object.hpp>
 #include <graphene/chain/proposal_object.hpp>
+#include <graphene/chain/hardfork.hpp>
 
 namespace graphene { namespace chain {
 
 bool proposal_object::is_authorized_to_execute(database& db) const
 {
+   // cheap to tell while approvals are still being collected; the verdict itself always comes from below
+   if( !db.get_proposal_authorizations().may_be_authorized( *this, db ) )
+      return false;
+
    transaction_evaluation_state dry_run_eval(&db);
 
    try {
@@ -39,7 +44,8 @@ bool proposal_object::is_authorized_to_execute(database& db) const
                         db.get_global_properties().parameters.max_authority_depth,
                         true, /* allow committeee */
                         available_active_approvals,
-                        available_owner_approvals );
+                        available_owner_approvals,
+                        db.head_block_time() < HARDFORK_ADDRESS_AUTH_TIME );
    } 
    catch ( const fc::exception& e )
    {
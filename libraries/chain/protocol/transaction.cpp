@@ -37,6 +37,13 @@ digest_type processed_transaction::merkle_digest()const
    return enc.result();
 }
 
+transaction_id_type processed_transaction::id()const
+{
+   if( _trx_id == transaction_id_type() )
+      _trx_id = transaction::id();
+   return _trx_id;
+}
+
 digest_type transaction::digest()const
 {
    digest_type::encoder enc;
@@ -52,6 +59,22 @@ digest_type transaction::sig_digest( const chain_id_type& chain_id )const
    return enc.result();
 }
 
+transaction_id_type transaction::id_from_packed( const vector<char>& packed )
+{
+   auto h = digest_type::hash( packed.data(), packed.size() );
+   transaction_id_type result;
+   memcpy(result._hash, h._hash, std::min(sizeof(result), sizeof(h)));
+   return result;
+}
+
+digest_type transaction::sig_digest_from_packed( const chain_id_type& chain_id, const vector<char>& packed )
+{
+   digest_type::encoder enc;
+   fc::raw::pack( enc, chain_id );
+   enc.write( packed.data(), packed.size() );
+   return enc.result();
+}
+
 void transaction::validate() const
 {
    FC_ASSERT( operations.size() > 0, "A transaction must have at least one operation", ("trx",*this) );
@@ -120,40 +143,33 @@ struct sign_state
          return itr->second = true;
       }
 
-      optional<map<address,public_key_type>> available_address_sigs;
-      optional<map<address,public_key_type>> provided_address_sigs;
+      /** maps every address form of the provided and available keys to its key,
+       * built once on the first address lookup
+       */
+      optional<flat_map<address,public_key_type>> address_keys;
+
+      void add_address_forms( const public_key_type& k )
+      {
+         (*address_keys)[ address(pts_address(k, false, 56) ) ] = k;
+         (*address_keys)[ address(pts_address(k, true, 56) ) ] = k;
+         (*address_keys)[ address(pts_address(k, false, 0) ) ] = k;
+         (*address_keys)[ address(pts_address(k, true, 0) ) ] = k;
+         (*address_keys)[ address(k) ] = k;
+      }
 
       bool signed_by( const address& a ) {
-         if( !available_address_sigs ) {
-            available_address_sigs = std::map<address,public_key_type>();
-            provided_address_sigs = std::map<address,public_key_type>();
-            for( auto& item : available_keys ) {
-             (*available_address_sigs)[ address(pts_address(item, false, 56) ) ] = item;
-             (*available_address_sigs)[ address(pts_address(item, true, 56) ) ] = item;
-             (*available_address_sigs)[ address(pts_address(item, false, 0) ) ] = item;
-             (*available_address_sigs)[ address(pts_address(item, true, 0) ) ] = item;
-             (*available_address_sigs)[ address(item) ] = item;
-            }
-            for( auto& item : provided_signatures ) {
-             (*provided_address_sigs)[ address(pts_address(item.first, false, 56) ) ] = item.first;
-             (*provided_address_sigs)[ address(pts_address(item.first, true, 56) ) ] = item.first;
-             (*provided_address_sigs)[ address(pts_address(item.first, false, 0) ) ] = item.first;
-             (*provided_address_sigs)[ address(pts_address(item.first, true, 0) ) ] = item.first;
-             (*provided_address_sigs)[ address(item.first) ] = item.first;
-            }
+         if( !address_keys ) {
+            address_keys = flat_map<address,public_key_type>();
+            address_keys->reserve( 5 * (available_keys.size() + provided_signatures.size()) );
+            for( auto& item : available_keys )
+               add_address_forms( item );
+            for( auto& item : provided_signatures )
+               add_address_forms( item.first );
          }
-         auto itr = provided_address_sigs->find(a);
-         if( itr == provided_address_sigs->end() )
-         {
-            auto aitr = available_address_sigs->find(a);
-            if( aitr != available_address_sigs->end() ) {
-               auto pk = available_keys.find(aitr->second);
-               if( pk != available_keys.end() )
-                  return provided_signatures[aitr->second] = true;
-               return false;
-            }
-         }
-         return provided_signatures[itr->second] = true;
+         auto itr = address_keys->find(a);
+         if( itr == address_keys->end() )
+            return unmatched_addresses_signed;
+         return signed_by( itr->second );
       }
 
       bool check_authority( account_id_type id )
@@ -240,6 +256,10 @@ struct sign_state
       flat_map<public_key_type,bool>   provided_signatures;
       flat_set<account_id_type>        approved_by;
       uint32_t                         max_recursion = GRAPHENE_MAX_SIG_CHECK_DEPTH;
+      /** the lookup of an address matching no key used to read past the end of the address map and count it
+       * as signed, see verify_authority()
+       */
+      bool                             unmatched_addresses_signed = false;
 };
 
 
@@ -249,7 +269,8 @@ void verify_authority( const vector<operation>& ops, const flat_set<public_key_t
                        uint32_t max_recursion_depth,
                        bool  allow_committe,
                        const flat_set<account_id_type>& active_aprovals,
-                       const flat_set<account_id_type>& owner_approvals )
+                       const flat_set<account_id_type>& owner_approvals,
+                       bool unmatched_addresses_signed )
 { try {
    flat_set<account_id_type> required_active;
    flat_set<account_id_type> required_owner;
@@ -264,6 +285,7 @@ void verify_authority( const vector<operation>& ops, const flat_set<public_key_t
 
    sign_state s(sigs,get_active);
    s.max_recursion = max_recursion_depth;
+   s.unmatched_addresses_signed = unmatched_addresses_signed;
    for( auto& id : active_aprovals )
       s.approved_by.insert( id );
    for( auto& id : owner_approvals )
@@ -299,7 +321,11 @@ void verify_authority( const vector<operation>& ops, const flat_set<public_key_t
 
 flat_set<public_key_type> signed_transaction::get_signature_keys( const chain_id_type& chain_id )const
 { try {
-   auto d = sig_digest( chain_id );
+   return get_signature_keys_from_digest( sig_digest( chain_id ) );
+} FC_CAPTURE_AND_RETHROW() }
+
+flat_set<public_key_type> signed_transaction::get_signature_keys_from_digest( const digest_type& d )const
+{ try {
    flat_set<public_key_type> result;
    for( const auto&  sig : signatures )
    {
@@ -378,9 +404,12 @@ void signed_transaction::verify_authority(
    const chain_id_type& chain_id,
    const std::function<const authority*(account_id_type)>& get_active,
    const std::function<const authority*(account_id_type)>& get_owner,
-   uint32_t max_recursion )const
+   uint32_t max_recursion,
+   bool unmatched_addresses_signed )const
 { try {
-   graphene::chain::verify_authority( operations, get_signature_keys( chain_id ), get_active, get_owner, max_recursion );
+   graphene::chain::verify_authority( operations, get_signature_keys( chain_id ), get_active, get_owner, max_recursion,
+                                      false, flat_set<account_id_type>(), flat_set<account_id_type>(),
+                                      unmatched_addresses_signed );
 } FC_CAPTURE_AND_RETHROW( (*this) ) }
 
 } } // graphene::chain
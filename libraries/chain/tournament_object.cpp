@@ -484,6 +484,40 @@ namespace graphene { namespace chain {
       return *this;
    }
 
+   // moving hands the state machine over instead of allocating and copying a new one; undo
+   // restores objects with move_from(), and create() moves the new object into the index
+   tournament_object::tournament_object(tournament_object&& rhs) :
+      graphene::db::abstract_object<tournament_object>(rhs),
+      creator(rhs.creator),
+      options(std::move(rhs.options)),
+      start_time(std::move(rhs.start_time)),
+      end_time(std::move(rhs.end_time)),
+      prize_pool(rhs.prize_pool),
+      registered_players(rhs.registered_players),
+      tournament_details_id(rhs.tournament_details_id),
+      my(std::move(rhs.my))
+   {
+      my->state_machine.tournament_obj = this;
+   }
+
+   tournament_object& tournament_object::operator=(tournament_object&& rhs)
+   {
+      id = rhs.id;
+      creator = rhs.creator;
+      options = std::move(rhs.options);
+      start_time = std::move(rhs.start_time);
+      end_time = std::move(rhs.end_time);
+      prize_pool = rhs.prize_pool;
+      registered_players = rhs.registered_players;
+      tournament_details_id = rhs.tournament_details_id;
+      std::swap(my, rhs.my);
+      my->state_machine.tournament_obj = this;
+      if (rhs.my)
+         rhs.my->state_machine.tournament_obj = &rhs;
+
+      return *this;
+   }
+
    tournament_object::~tournament_object()
    {
    }
@@ -719,8 +753,6 @@ namespace fc {
    // Manually reflect tournament_object to variant to properly reflect "state"
    void to_variant(const graphene::chain::tournament_object& tournament_obj, fc::variant& v)
    {
-      fc_elog(fc::logger::get("tournament"), "In tournament_obj to_variant");
-      elog("In tournament_obj to_variant");
       fc::mutable_variant_object o;
       o("id", tournament_obj.id)
        ("creator", tournament_obj.creator)
@@ -738,7 +770,6 @@ namespace fc {
    // Manually reflect tournament_object to variant to properly reflect "state"
    void from_variant(const fc::variant& v, graphene::chain::tournament_object& tournament_obj)
    {
-      fc_elog(fc::logger::get("tournament"), "In tournament_obj from_variant");
       tournament_obj.id = v["id"].as<graphene::chain::tournament_id_type>();
       tournament_obj.creator = v["creator"].as<graphene::chain::account_id_type>();
       tournament_obj.options = v["options"].as<graphene::chain::tournament_options>();
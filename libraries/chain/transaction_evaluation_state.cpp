@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/transaction_evaluation_state.hpp>
+#include <graphene/chain/database.hpp>
+
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/asset_object.hpp>
+#include <graphene/chain/global_property_object.hpp>
+
+namespace graphene { namespace chain {
+
+namespace {
+   // a transaction touches a handful of objects of each kind, a linear scan beats anything fancier; contexts
+   // reused for many operations, such as the one cancelling expired orders, only keep the first few
+   const size_t max_cached_objects = 16;
+
+   template<typename ObjectType, typename Resolve>
+   const ObjectType& find_or_resolve( vector<const ObjectType*>& cache, object_id_type id,
+                                      evaluation_cache_stats& stats, Resolve resolve )
+   {
+      ++stats.lookups;
+      for( const ObjectType* obj : cache )
+      {
+         if( obj->id == id )
+         {
+            ++stats.hits;
+            return *obj;
+         }
+      }
+      const ObjectType& obj = resolve();
+      if( cache.size() < max_cached_objects )
+         cache.push_back( &obj );
+      return obj;
+   }
+}
+
+const account_object& transaction_evaluation_state::get_account( account_id_type id )
+{
+   return find_or_resolve( _accounts, id, cache_stats, [&]() -> const account_object& { return id(db()); } );
+}
+
+const account_statistics_object& transaction_evaluation_state::get_account_statistics( const account_object& account )
+{
+   return find_or_resolve( _account_statistics, account.statistics, cache_stats,
+                           [&]() -> const account_statistics_object& { return account.statistics(db()); } );
+}
+
+const asset_object& transaction_evaluation_state::get_asset( asset_id_type id )
+{
+   return find_or_resolve( _assets, id, cache_stats, [&]() -> const asset_object& { return id(db()); } );
+}
+
+const asset_dynamic_data_object& transaction_evaluation_state::get_asset_dynamic_data( const asset_object& asset )
+{
+   return find_or_resolve( _asset_dynamic_data, asset.dynamic_asset_data_id, cache_stats,
+                           [&]() -> const asset_dynamic_data_object& { return asset.dynamic_asset_data_id(db()); } );
+}
+
+const global_property_object& transaction_evaluation_state::get_global_properties()
+{
+   ++cache_stats.lookups;
+   if( _global_properties != nullptr )
+      ++cache_stats.hits;
+   else
+      _global_properties = &db().get_global_properties();
+   return *_global_properties;
+}
+
+} } // graphene::chain
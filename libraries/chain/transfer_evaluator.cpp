@@ -33,9 +33,9 @@ void_result transfer_evaluator::do_evaluate( const transfer_operation& op )
    
    const database& d = db();
 
-   const account_object& from_account    = op.from(d);
-   const account_object& to_account      = op.to(d);
-   const asset_object&   asset_type      = op.amount.asset_id(d);
+   const account_object& from_account    = trx_state->get_account(op.from);
+   const account_object& to_account      = trx_state->get_account(op.to);
+   const asset_object&   asset_type      = trx_state->get_asset(op.amount.asset_id);
 
    try {
 
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/vote_tally_tracker.hpp>
+
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/global_property_object.hpp>
+#include <graphene/chain/vesting_balance_object.hpp>
+
+namespace graphene { namespace chain {
+
+void vote_tally_tracker::object_inserted( const object& obj )
+{
+   if( obj.id.is<account_id_type>() )
+      add_account( static_cast<const account_object&>(obj) );
+   else
+   {
+      auto stake = get_stake( obj );
+      adjust_voting_stake( stake.first, stake.second );
+   }
+}
+
+void vote_tally_tracker::object_removed( const object& obj )
+{
+   if( obj.id.is<account_id_type>() )
+      remove_account( static_cast<const account_object&>(obj) );
+   else
+   {
+      auto stake = get_stake( obj );
+      adjust_voting_stake( stake.first, -stake.second );
+   }
+}
+
+void vote_tally_tracker::about_to_modify( const object& before )
+{
+   if( before.id.is<account_id_type>() )
+      remove_account( static_cast<const account_object&>(before) );
+   else
+      _stake_before = get_stake( before );
+}
+
+void vote_tally_tracker::object_modified( const object& after )
+{
+   if( after.id.is<account_id_type>() )
+      add_account( static_cast<const account_object&>(after) );
+   else
+   {
+      // most modifications are balance changes, apply them as a single delta
+      auto stake = get_stake( after );
+      if( stake.first == _stake_before.first )
+         adjust_voting_stake( stake.first, stake.second - _stake_before.second );
+      else
+      {
+         adjust_voting_stake( _stake_before.first, -_stake_before.second );
+         adjust_voting_stake( stake.first, stake.second );
+      }
+   }
+}
+
+void vote_tally_tracker::clear()
+{
+   _accounts.clear();
+   _vote_tally.clear();
+   _witness_count_stake.clear();
+   _committee_count_stake.clear();
+   _total_voting_stake = 0;
+}
+
+void vote_tally_tracker::get_tally( const global_property_object& gpo, vote_tally_buffers& tally )const
+{
+   tally.vote_tally.assign( gpo.next_available_vote_id, 0 );
+   for( size_t i = 0; i < tally.vote_tally.size() && i < _vote_tally.size(); ++i )
+      tally.vote_tally[i] = _vote_tally[i].value;
+
+   // votes for more witnesses (committee members) than allowed are ignored, see vote_tally_helper
+   tally.witness_count_histogram.assign( gpo.parameters.maximum_witness_count / 2 + 1, 0 );
+   for( const auto& item : _witness_count_stake )
+      if( item.first <= gpo.parameters.maximum_witness_count )
+         tally.witness_count_histogram[std::min( size_t(item.first / 2), tally.witness_count_histogram.size() - 1 )]
+               += item.second.value;
+   tally.committee_count_histogram.assign( gpo.parameters.maximum_committee_count / 2 + 1, 0 );
+   for( const auto& item : _committee_count_stake )
+      if( item.first <= gpo.parameters.maximum_committee_count )
+         tally.committee_count_histogram[std::min( size_t(item.first / 2), tally.committee_count_histogram.size() - 1 )]
+               += item.second.value;
+
+   tally.total_voting_stake = _total_voting_stake.value;
+}
+
+void vote_tally_tracker::add_stake_to_tally( account_id_type account, share_type delta,
+                                             const global_property_object& gpo, vote_tally_buffers& tally )const
+{
+   if( delta == 0 || account.instance.value >= _accounts.size() || !_accounts[account.instance.value].counted )
+      return;
+   const account_object* opinion_account = _db.find( _accounts[account.instance.value].opinion_account );
+   if( opinion_account == nullptr )
+      return;
+
+   for( vote_id_type id : opinion_account->options.votes )
+      if( id.instance() < tally.vote_tally.size() )
+         tally.vote_tally[id.instance()] += delta.value;
+   if( opinion_account->options.num_witness <= gpo.parameters.maximum_witness_count )
+      tally.witness_count_histogram[std::min( size_t(opinion_account->options.num_witness / 2),
+                                              tally.witness_count_histogram.size() - 1 )] += delta.value;
+   if( opinion_account->options.num_committee <= gpo.parameters.maximum_committee_count )
+      tally.committee_count_histogram[std::min( size_t(opinion_account->options.num_committee / 2),
+                                                tally.committee_count_histogram.size() - 1 )] += delta.value;
+   tally.total_voting_stake += delta.value;
+}
+
+vote_tally_tracker::account_entry& vote_tally_tracker::get_entry( account_id_type account )
+{
+   if( account.instance.value >= _accounts.size() )
+      _accounts.resize( account.instance.value + 1 );
+   return _accounts[account.instance.value];
+}
+
+std::pair<account_id_type, share_type> vote_tally_tracker::get_stake( const object& obj )const
+{
+   if( obj.id.is<account_balance_id_type>() )
+   {
+      const account_balance_object& balance = static_cast<const account_balance_object&>(obj);
+      return std::make_pair( balance.owner, balance.asset_type == asset_id_type() ? balance.balance : share_type() );
+   }
+   if( obj.id.is<vesting_balance_id_type>() )
+   {
+      const vesting_balance_object& vesting = static_cast<const vesting_balance_object&>(obj);
+      share_type stake = vesting.balance.asset_id == asset_id_type() ? vesting.balance.amount : share_type();
+      if( vesting.owner.instance.value < _accounts.size() )
+      {
+         const optional<vesting_balance_id_type>& cashback_vb = _accounts[vesting.owner.instance.value].cashback_vb;
+         if( cashback_vb.valid() && *cashback_vb == vesting_balance_id_type(vesting.id) )
+            stake += vesting.balance.amount;
+      }
+      return std::make_pair( vesting.owner, stake );
+   }
+   assert( obj.id.is<account_statistics_id_type>() );
+   const account_statistics_object& stats = static_cast<const account_statistics_object&>(obj);
+   return std::make_pair( stats.owner, stats.total_core_in_orders );
+}
+
+void vote_tally_tracker::adjust_voting_stake( account_id_type account, share_type delta )
+{
+   if( delta == 0 )
+      return;
+   account_entry& entry = get_entry( account );
+   entry.voting_stake += delta;
+   if( entry.counted )
+      adjust_proxied_stake( entry.opinion_account, delta );
+}
+
+void vote_tally_tracker::adjust_proxied_stake( account_id_type account, share_type delta )
+{
+   account_entry& entry = get_entry( account );
+   entry.proxied_stake += delta;
+   if( entry.counted )
+      apply_opinions( account(_db), delta );
+}
+
+void vote_tally_tracker::apply_opinions( const account_object& opinion_account, share_type delta )
+{
+   if( delta == 0 )
+      return;
+   for( vote_id_type id : opinion_account.options.votes )
+   {
+      if( id.instance() >= _vote_tally.size() )
+         _vote_tally.resize( id.instance() + 1 );
+      _vote_tally[id.instance()] += delta;
+   }
+   _witness_count_stake[opinion_account.options.num_witness] += delta;
+   _committee_count_stake[opinion_account.options.num_committee] += delta;
+   _total_voting_stake += delta;
+}
+
+void vote_tally_tracker::add_account( const account_object& a )
+{
+   account_entry& entry = get_entry( a.id );
+   assert( !entry.counted );
+
+   // vesting balances report the cashback a second time once the account refers to them
+   entry.cashback_vb = a.cashback_vb;
+   if( a.cashback_vb.valid() )
+      if( const vesting_balance_object* cashback = _db.find( *a.cashback_vb ) )
+         entry.voting_stake += cashback->balance.amount;
+
+   entry.counted = true;
+   entry.opinion_account = a.options.voting_account == GRAPHENE_PROXY_TO_SELF_ACCOUNT ? a.get_id()
+                                                                                      : a.options.voting_account;
+   // apply the stake proxied so far before adding our own, which may be proxied to ourselves
+   apply_opinions( a, entry.proxied_stake );
+   adjust_proxied_stake( entry.opinion_account, entry.voting_stake );
+}
+
+void vote_tally_tracker::remove_account( const account_object& a )
+{
+   account_entry& entry = get_entry( a.id );
+   assert( entry.counted );
+
+   // the opinion account got its entry when this account was added, so this cannot move entry
+   adjust_proxied_stake( entry.opinion_account, -entry.voting_stake );
+   apply_opinions( a, -entry.proxied_stake );
+   entry.counted = false;
+
+   if( entry.cashback_vb.valid() )
+      if( const vesting_balance_object* cashback = _db.find( *entry.cashback_vb ) )
+         entry.voting_stake -= cashback->balance.amount;
+   entry.cashback_vb.reset();
+}
+
+} } // graphene::chain
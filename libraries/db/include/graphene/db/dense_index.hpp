@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <graphene/db/generic_index.hpp>
+
+#include <memory>
+
+namespace graphene { namespace chain {
+
+   /**
+    *  @class dense_index
+    *  @brief A generic_index that also addresses its objects by instance number
+    *
+    *  Ids are allocated sequentially, so besides the multi_index container, which keeps owning the objects
+    *  and provides every ordering including by_id, this index keeps a table of object pointers addressed by
+    *  instance.  find() and therefore database::get() and database::find() become an array lookup instead of
+    *  a walk down the by_id tree.  The table is split in fixed size chunks so that it grows without moving
+    *  what is already there.  A chunk is freed once all its objects are removed, so indexes whose ids keep
+    *  growing while few objects are alive, like limit orders, only keep a null pointer per chunk_size
+    *  instances they went past.
+    *
+    *  This is the preferred index type for objects that are looked up by id a lot and allocated densely.
+    */
+   template<typename ObjectType, typename MultiIndexType>
+   class dense_index : public generic_index<ObjectType, MultiIndexType>
+   {
+         typedef generic_index<ObjectType, MultiIndexType> base_type;
+
+      public:
+         static const uint64_t chunk_bits = 12;
+         static const uint64_t chunk_size = uint64_t(1) << chunk_bits;
+
+         virtual const object& insert( object&& obj )override
+         {
+            const object& result = base_type::insert( std::move( obj ) );
+            set_slot( result.id.instance(), static_cast<const ObjectType*>( &result ) );
+            return result;
+         }
+
+         virtual const object& create( const std::function<void(object&)>& constructor )override
+         {
+            const object& result = base_type::create( constructor );
+            set_slot( result.id.instance(), static_cast<const ObjectType*>( &result ) );
+            return result;
+         }
+
+         virtual void modify( const object& obj, const std::function<void(object&)>& m )override
+         {
+            object_id_type id = obj.id;
+            try
+            {
+               base_type::modify( obj, m );
+            }
+            catch( ... )
+            {
+               // multi_index drops an element whose modification violates a constraint
+               if( base_type::find( id ) == nullptr )
+                  clear_slot( id.instance() );
+               throw;
+            }
+         }
+
+         virtual void remove( const object& obj )override
+         {
+            clear_slot( obj.id.instance() );
+            base_type::remove( obj );
+         }
+
+         virtual const object* find( object_id_type id )const override
+         {
+            const uint64_t instance = id.instance();
+            const uint64_t chunk = instance >> chunk_bits;
+            if( chunk >= _chunks.size() || !_chunks[chunk].slots )
+               return nullptr;
+            return _chunks[chunk].slots[instance & (chunk_size - 1)];
+         }
+
+         /// the chunks currently allocated
+         size_t allocated_chunks()const
+         {
+            size_t count = 0;
+            for( const chunk_type& c : _chunks )
+               if( c.slots )
+                  ++count;
+            return count;
+         }
+
+      private:
+         struct chunk_type
+         {
+            std::unique_ptr< const ObjectType*[] > slots;
+            /// the slots that are not null
+            uint64_t                               used = 0;
+         };
+
+         void set_slot( uint64_t instance, const ObjectType* obj )
+         {
+            const uint64_t chunk = instance >> chunk_bits;
+            if( chunk >= _chunks.size() )
+               _chunks.resize( chunk + 1 );
+            chunk_type& c = _chunks[chunk];
+            if( !c.slots )
+               c.slots.reset( new const ObjectType*[chunk_size]() );
+            const ObjectType*& s = c.slots[instance & (chunk_size - 1)];
+            if( s == nullptr )
+               ++c.used;
+            s = obj;
+         }
+
+         void clear_slot( uint64_t instance )
+         {
+            const uint64_t chunk = instance >> chunk_bits;
+            if( chunk >= _chunks.size() || !_chunks[chunk].slots )
+               return;
+            chunk_type& c = _chunks[chunk];
+            const ObjectType*& s = c.slots[instance & (chunk_size - 1)];
+            if( s == nullptr )
+               return;
+            s = nullptr;
+            if( --c.used == 0 )
+               c.slots.reset();
+         }
+
+         std::vector< chunk_type > _chunks;
+   };
+
+} }
@@ -164,10 +164,11 @@ namespace graphene { namespace db {
          /** called just after obj is modified */
          void on_modify( const object& obj );
 
-         template<typename T>
-         void add_secondary_index()
+         template<typename T, typename... Args>
+         T* add_secondary_index( Args&&... args )
          {
-            _sindex.emplace_back( new T() );
+            _sindex.emplace_back( new T( std::forward<Args>(args)... ) );
+            return static_cast<T*>( _sindex.back().get() );
          }
 
          template<typename T>
@@ -181,9 +182,21 @@ namespace graphene { namespace db {
             FC_THROW_EXCEPTION( fc::assert_exception, "invalid index type" );
          }
 
+         template<typename T>
+         T& get_secondary_index()
+         {
+            for( const auto& item : _sindex )
+            {
+               T* result = dynamic_cast<T*>(item.get());
+               if( result != nullptr ) return *result;
+            }
+            FC_THROW_EXCEPTION( fc::assert_exception, "invalid index type" );
+         }
+
       protected:
          vector< shared_ptr<index_observer> >   _observers;
          vector< unique_ptr<secondary_index> >  _sindex;
+         vector< unique_ptr<secondary_index> >  _deferred_sindex;
 
       private:
          object_database& _db;
@@ -251,10 +264,11 @@ namespace graphene { namespace db {
             auto ver  = get_object_version();
             fc::raw::pack( out, _next_id );
             fc::raw::pack( out, ver );
+            // the same bytes as packing a vector<char> holding the packed object, without building one
             this->inspect_all_objects( [&]( const object& o ) {
-                auto vec = fc::raw::pack( static_cast<const object_type&>(o) );
-                auto packed_vec = fc::raw::pack( vec );
-                out.write( packed_vec.data(), packed_vec.size() );
+                const auto& obj = static_cast<const object_type&>(o);
+                fc::raw::pack( out, fc::unsigned_int( fc::raw::pack_size( obj ) ) );
+                fc::raw::pack( out, obj );
             });
          }
 
@@ -267,6 +281,15 @@ namespace graphene { namespace db {
          }
 
 
+         /** used by undo to restore removed objects */
+         virtual const object&  insert( object&& obj )override
+         {
+            const auto& result = DerivedIndex::insert( std::move( obj ) );
+            for( const auto& item : _sindex )
+               item->object_inserted( result );
+            return result;
+         }
+
          virtual const object&  create(const std::function<void(object&)>& constructor )override
          {
             const auto& result = DerivedIndex::create( constructor );
@@ -295,6 +318,30 @@ namespace graphene { namespace db {
             on_modify( obj );
          }
 
+         /**
+          *  Stops updating the secondary indexes on every insert, modify and remove.  Meant for bulk
+          *  loads such as genesis, where the secondary indexes have not seen any object yet and can be
+          *  built once from the final state by rebuild_secondary_indexes().
+          */
+         void defer_secondary_indexes()
+         {
+            FC_ASSERT( _deferred_sindex.empty(), "secondary indexes are already deferred" );
+            _deferred_sindex = std::move( _sindex );
+            _sindex.clear();
+         }
+
+         /** restores the secondary indexes taken by defer_secondary_indexes() and feeds them every object */
+         void rebuild_secondary_indexes()
+         {
+            for( auto& item : _deferred_sindex )
+               _sindex.emplace_back( std::move( item ) );
+            _deferred_sindex.clear();
+            this->inspect_all_objects( [&]( const object& o ) {
+               for( const auto& item : _sindex )
+                  item->object_inserted( o );
+            });
+         }
+
          virtual void add_observer( const shared_ptr<index_observer>& o ) override
          {
             _observers.emplace_back( o );
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <fc/io/raw.hpp>
+
+#include <vector>
+
+namespace graphene { namespace db {
+
+   /**
+    * Packs @p v into a buffer owned by the calling thread, sized by fc::raw::pack_size() first.
+    *
+    * The buffer is reused by the next call on the same thread, so once it grew to the largest size
+    * needed packing no longer allocates.  The returned bytes are only valid until then; callers must
+    * use them before packing anything else through this function.
+    */
+   template<typename T>
+   const std::vector<char>& pack_to_buffer( const T& v )
+   {
+      static thread_local std::vector<char> buffer;
+      buffer.resize( fc::raw::pack_size( v ) );
+      if( !buffer.empty() )
+      {
+         fc::datastream<char*> ds( buffer.data(), buffer.size() );
+         fc::raw::pack( ds, v );
+      }
+      return buffer;
+   }
+
+} } // graphene::db
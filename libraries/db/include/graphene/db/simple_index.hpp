@@ -88,6 +88,9 @@ namespace graphene { namespace db {
             return _objects[instance].get();
          }
 
+         /** pre-sizes the slot vector when the number of objects about to be created is known */
+         void reserve( size_t n ) { _objects.reserve( n ); }
+
          virtual void inspect_all_objects(std::function<void (const object&)> inspector)const override
          {
             try {
@@ -32,6 +32,7 @@
 #include <fc/api.hpp>
 #include <fc/smart_ref_impl.hpp>
 
+#include <deque>
 
 namespace graphene { namespace delayed_node {
 namespace bpo = boost::program_options;
@@ -45,6 +46,42 @@ struct delayed_node_plugin_impl {
    boost::signals2::scoped_connection client_connection_closed;
    graphene::chain::block_id_type last_received_remote_head;
    graphene::chain::block_id_type last_processed_remote_head;
+   /** blocks asked for in one get_blocks call */
+   uint32_t blocks_per_request = 200;
+   /** get_blocks calls kept in flight while the blocks already received are applied */
+   size_t max_prefetch_requests = 4;
+   /** cleared once the trusted node turned out to be too old to know get_blocks */
+   bool trusted_node_has_get_blocks = true;
+
+   /** up to count blocks starting at first, packed, asking for them one by one if get_blocks is missing */
+   std::vector<std::vector<char>> fetch_blocks( uint32_t first, uint32_t count )
+   {
+      if( trusted_node_has_get_blocks )
+      {
+         try
+         {
+            return database_api->get_blocks( first, count );
+         }
+         catch( const fc::exception& e )
+         {
+            if( e.to_detail_string().find( "no method with name" ) == std::string::npos )
+               throw;
+            wlog( "Trusted node doesn't support get_blocks, fetching blocks one by one" );
+            trusted_node_has_get_blocks = false;
+         }
+      }
+
+      std::vector<std::vector<char>> packed_blocks;
+      packed_blocks.reserve( count );
+      for( uint32_t block_num = first; block_num < first + count; ++block_num )
+      {
+         fc::optional<graphene::chain::signed_block> block = database_api->get_block( block_num );
+         if( !block.valid() )
+            break;
+         packed_blocks.push_back( fc::raw::pack( *block ) );
+      }
+      return packed_blocks;
+   }
 };
 }
 
@@ -82,6 +119,7 @@ void delayed_node_plugin::sync_with_trusted_node()
    auto& db = database();
    uint32_t synced_blocks = 0;
    uint32_t pass_count = 0;
+   fc::time_point start_time = fc::time_point::now();
    while( true )
    {
       graphene::chain::dynamic_global_property_object remote_dpo = my->database_api->get_dynamic_global_properties();
@@ -93,18 +131,57 @@ void delayed_node_plugin::sync_with_trusted_node()
          }
          if( synced_blocks > 1 )
          {
-            ilog( "Delayed node finished syncing ${n} blocks in ${k} passes", ("n", synced_blocks)("k", pass_count) );
+            int64_t elapsed_ms = std::max<int64_t>( (fc::time_point::now() - start_time).count() / 1000, 1 );
+            ilog( "Delayed node finished syncing ${n} blocks in ${k} passes, ${t} milliseconds (${r} blocks/s)",
+                  ("n", synced_blocks)("k", pass_count)("t", elapsed_ms)("r", synced_blocks * 1000 / elapsed_ms) );
          }
          break;
       }
       pass_count++;
-      while( remote_dpo.last_irreversible_block_num > db.head_block_num() )
+
+      // The next batches are requested before the current one is applied, so fetching from the trusted
+      // node overlaps with applying locally.  At most max_prefetch_requests batches are outstanding.
+      const uint32_t last_block_num = remote_dpo.last_irreversible_block_num;
+      uint32_t next_block_num = db.head_block_num() + 1;
+      std::deque< std::pair< uint32_t, fc::future< std::vector<std::vector<char>> > > > prefetch;
+      auto request_more = [&]()
       {
-         fc::optional<graphene::chain::signed_block> block = my->database_api->get_block( db.head_block_num()+1 );
-         FC_ASSERT(block, "Trusted node claims it has blocks it doesn't actually have.");
-         ilog("Pushing block #${n}", ("n", block->block_num()));
-         db.push_block(*block);
-         synced_blocks++;
+         while( prefetch.size() < my->max_prefetch_requests && next_block_num <= last_block_num )
+         {
+            uint32_t first = next_block_num;
+            uint32_t count = std::min( my->blocks_per_request, last_block_num - next_block_num + 1 );
+            prefetch.emplace_back( first, fc::async( [this,first,count]() {
+               return my->fetch_blocks( first, count );
+            } ) );
+            next_block_num += count;
+         }
+      };
+
+      request_more();
+      while( !prefetch.empty() )
+      {
+         if( prefetch.front().first != db.head_block_num() + 1 )
+         {
+            // the trusted node sent a short batch, so the batches requested after it don't line up
+            prefetch.clear();
+            next_block_num = db.head_block_num() + 1;
+            request_more();
+            continue;
+         }
+         std::vector<std::vector<char>> packed_blocks = prefetch.front().second.wait();
+         prefetch.pop_front();
+         FC_ASSERT( !packed_blocks.empty(), "Trusted node claims it has blocks it doesn't actually have." );
+
+         request_more();
+         fc::yield(); // let the new requests go out before applying this batch
+
+         ilog( "Pushing blocks #${first} to #${last}",
+               ("first", db.head_block_num() + 1)("last", db.head_block_num() + packed_blocks.size()) );
+         for( const std::vector<char>& packed_block : packed_blocks )
+         {
+            db.push_block( fc::raw::unpack<graphene::chain::signed_block>( packed_block ) );
+            synced_blocks++;
+         }
       }
    }
 }
@@ -203,7 +203,7 @@ void generate_uia_sharedrop_genesis_plugin::generate_snapshot()
         for (const graphene::chain::genesis_state_type::initial_bts_account_type& initial_bts_account : new_genesis_state.initial_bts_accounts)
         {
             std::string account_name = unmodify_account_name(initial_bts_account.name);
-            auto& account_by_name_index = d.get_index_type<graphene::chain::account_index>().indices().get<graphene::chain::by_name>();
+            auto& account_by_name_index = d.get_index_type<graphene::chain::account_index>().indices().get<graphene::chain::by_name_hash>();
             auto account_iter = account_by_name_index.find(account_name);
             FC_ASSERT(account_iter != account_by_name_index.end(), "No account ${name}", ("name", account_name));
             uia_sharedrop_balance_object balance_object;
@@ -28,6 +28,8 @@
 
 #include <fc/thread/future.hpp>
 
+#include <deque>
+
 namespace graphene { namespace witness_plugin {
 
 namespace block_production_condition
@@ -46,6 +48,16 @@ namespace block_production_condition
    };
 }
 
+/// how long generate_block took for the blocks this node produced recently
+struct production_latency
+{
+   uint32_t         samples = 0;
+   fc::microseconds p50;
+   fc::microseconds p90;
+   fc::microseconds p99;
+   fc::microseconds max;
+};
+
 class witness_plugin : public graphene::app::plugin {
 public:
    ~witness_plugin() {
@@ -68,6 +80,9 @@ public:
 
    void set_block_production(bool allow) { _production_enabled = allow; }
 
+   /** latency percentiles over the last blocks produced by this node */
+   production_latency get_production_latency()const;
+
    virtual void plugin_initialize( const boost::program_options::variables_map& options ) override;
    virtual void plugin_startup() override;
    virtual void plugin_shutdown() override;
@@ -85,6 +100,8 @@ private:
 
    std::map<chain::public_key_type, fc::ecc::private_key> _private_keys;
    std::set<chain::witness_id_type> _witnesses;
+   std::deque<fc::microseconds> _production_latencies;
+   uint64_t _produced_block_count = 0;
    fc::future<void> _block_production_task;
 };
 
@@ -34,6 +34,7 @@
 #include <fc/smart_ref_impl.hpp>
 #include <fc/thread/thread.hpp>
 
+#include <algorithm>
 #include <iostream>
 
 using namespace graphene::witness_plugin;
@@ -80,6 +81,8 @@ void witness_plugin::plugin_set_program_options(
          ("private-key", bpo::value<vector<string>>()->composing()->multitoken()->
           DEFAULT_VALUE_VECTOR(std::make_pair(chain::public_key_type(default_priv_key.get_public_key()), graphene::utilities::key_to_wif(default_priv_key))),
           "Tuple of [PublicKey, WIF private key] (may specify multiple times)")
+         ("produce-from-pending-state", bpo::bool_switch(),
+          "Produce blocks on top of the already applied pending transactions instead of applying them again at the slot time")
          ;
    config_file_options.add(command_line_options);
 }
@@ -121,6 +124,8 @@ void witness_plugin::plugin_initialize(const boost::program_options::variables_m
          _private_keys[key_id_to_wif_pair.first] = *private_key;
       }
    }
+   if( options.count("produce-from-pending-state") )
+      database().node_properties().produce_from_pending_state = options.at("produce-from-pending-state").as<bool>();
    ilog("witness plugin:  plugin_initialize() end");
 } FC_LOG_AND_RETHROW() }
 
@@ -192,7 +197,14 @@ block_production_condition::block_production_condition_enum witness_plugin::bloc
    switch( result )
    {
       case block_production_condition::produced:
-         ilog("Generated block #${n} with timestamp ${t} at time ${c}", (capture));
+         ilog("Generated block #${n} with timestamp ${t} at time ${c} in ${l} microseconds", (capture));
+         if( _produced_block_count % 100 == 0 )
+         {
+            production_latency latency = get_production_latency();
+            ilog("Block production latency over the last ${n} blocks: p50 ${p50}, p90 ${p90}, p99 ${p99}, max ${max} microseconds",
+                 ("n", latency.samples)("p50", latency.p50.count())("p90", latency.p90.count())
+                 ("p99", latency.p99.count())("max", latency.max.count()));
+         }
          break;
       case block_production_condition::not_synced:
          ilog("Not producing block because production is disabled until we receive a recent block (see: --enable-stale-production)");
@@ -299,15 +311,39 @@ block_production_condition::block_production_condition_enum witness_plugin::mayb
    //if (gpo.parameters.witness_schedule_algorithm == GRAPHENE_WITNESS_SCHEDULED_ALGORITHM)
    ilog("Witness ${id} production slot has arrived; generating a block now...", ("id", scheduled_witness));
 
+   fc::time_point generation_start = fc::time_point::now();
    auto block = db.generate_block(
       scheduled_time,
       scheduled_witness,
       private_key_itr->second,
       _production_skip_flags
       );
+   fc::microseconds latency = fc::time_point::now() - generation_start;
 
-   capture("n", block.block_num())("t", block.timestamp)("c", now);
+   _production_latencies.push_back( latency );
+   if( _production_latencies.size() > 1000 )
+      _production_latencies.pop_front();
+   ++_produced_block_count;
+
+   capture("n", block.block_num())("t", block.timestamp)("c", now)("l", latency.count());
    fc::async( [this,block](){ p2p_node().broadcast(net::block_message(block)); } );
 
    return block_production_condition::produced;
 }
+
+production_latency witness_plugin::get_production_latency()const
+{
+   production_latency result;
+   if( _production_latencies.empty() )
+      return result;
+
+   vector<fc::microseconds> sorted( _production_latencies.begin(), _production_latencies.end() );
+   std::sort( sorted.begin(), sorted.end() );
+   auto percentile = [&sorted]( size_t pct ) { return sorted[ (sorted.size() - 1) * pct / 100 ]; };
+   result.samples = sorted.size();
+   result.p50 = percentile( 50 );
+   result.p90 = percentile( 90 );
+   result.p99 = percentile( 99 );
+   result.max = sorted.back();
+   return result;
+}
@@ -1438,6 +1438,21 @@ class wallet_api
        */
       signed_transaction sign_transaction(signed_transaction tx, bool broadcast = false);
 
+      /** Builds, signs and broadcasts a list of operations.
+       *
+       * The operations are packed into as many transactions as needed, at most
+       * \c operations_per_transaction each, with fees set from the current fee schedule.
+       * Intended for scripted bulk operations such as payouts, where it saves the
+       * round trips of building each transaction separately.
+       * @param operations the operations to send, in order
+       * @param operations_per_transaction the maximum number of operations in one transaction
+       * @param broadcast true if you wish to broadcast the transactions
+       * @return the signed transactions
+       */
+      vector<signed_transaction> broadcast_operations(vector<operation> operations,
+                                                      uint32_t operations_per_transaction,
+                                                      bool broadcast = true);
+
       /** Returns an uninitialized object representing a given blockchain operation.
        *
        * This returns a default-initialized object of the given type; it can be used 
@@ -1753,6 +1768,7 @@ FC_API( graphene::wallet::wallet_api,
         (save_wallet_file)
         (serialize_transaction)
         (sign_transaction)
+        (broadcast_operations)
         (get_prototype_operation)
         (propose_parameter_change)
         (propose_fee_change)
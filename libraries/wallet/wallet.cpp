@@ -360,6 +360,29 @@ private:
    }
 
    fc::mutex _subscribed_object_changed_mutex;
+
+   // keeps the objects cached by get_global_properties(), get_account() and find_asset() in sync with the chain
+   void update_cached_object(const variant& changed_object_variant)
+   {
+      object_id_type id = changed_object_variant["id"].as<object_id_type>();
+      if (id.is<global_property_id_type>())
+      {
+         _global_properties_cache = changed_object_variant.as<global_property_object>();
+      }
+      else if (id.is<account_id_type>())
+      {
+         auto cache_iter = _account_cache.find(id);
+         if (cache_iter != _account_cache.end())
+            _account_cache.replace(cache_iter, changed_object_variant.as<account_object>());
+      }
+      else if (id.is<asset_id_type>())
+      {
+         auto cache_iter = _asset_cache.find(asset_id_type(id));
+         if (cache_iter != _asset_cache.end())
+            cache_iter->second = changed_object_variant.as<asset_object>();
+      }
+   }
+
    void subscribed_object_changed(const variant& changed_objects_variant)
    {
       fc::scoped_lock<fc::mutex> lock(_resync_mutex);
@@ -369,6 +392,7 @@ private:
          // changed_object_variant is either the object, or just the id if the object was removed
          if (changed_object_variant.is_object())
          {
+            update_cached_object(changed_object_variant);
             try
             {
                object_id_type id = changed_object_variant["id"].as<tournament_id_type>();
@@ -702,7 +726,10 @@ public:
    }
    global_property_object get_global_properties() const
    {
-      return _remote_db->get_global_properties();
+      // kept up to date by subscribed_object_changed()
+      if( !_global_properties_cache )
+         _global_properties_cache = _remote_db->get_global_properties();
+      return *_global_properties_cache;
    }
    dynamic_global_property_object get_dynamic_global_properties() const
    {
@@ -712,10 +739,48 @@ public:
    {
       if( _wallet.my_accounts.get<by_id>().count(id) )
          return *_wallet.my_accounts.get<by_id>().find(id);
+      auto cache_itr = _account_cache.get<by_id>().find(id);
+      if( cache_itr != _account_cache.get<by_id>().end() )
+         return *cache_itr;
       auto rec = _remote_db->get_accounts({id}).front();
       FC_ASSERT(rec);
+      _account_cache.insert(*rec);
       return *rec;
    }
+   /**
+    * Like database_api::get_accounts(), but only asks the remote node for the accounts
+    * which are not in _account_cache yet
+    */
+   vector<optional<account_object>> get_accounts(const vector<account_id_type>& account_ids) const
+   {
+      vector<optional<account_object>> result(account_ids.size());
+      vector<account_id_type> missing_ids;
+      vector<size_t> missing_positions;
+      for( size_t i = 0; i < account_ids.size(); ++i )
+      {
+         auto cache_itr = _account_cache.get<by_id>().find(account_ids[i]);
+         if( cache_itr != _account_cache.get<by_id>().end() )
+            result[i] = *cache_itr;
+         else
+         {
+            missing_ids.push_back(account_ids[i]);
+            missing_positions.push_back(i);
+         }
+      }
+      if( missing_ids.empty() )
+         return result;
+
+      vector<optional<account_object>> fetched = _remote_db->get_accounts(missing_ids);
+      FC_ASSERT( fetched.size() == missing_ids.size() );
+      for( size_t i = 0; i < fetched.size(); ++i )
+      {
+         if( !fetched[i] )
+            continue;
+         _account_cache.insert(*fetched[i]);
+         result[missing_positions[i]] = std::move(fetched[i]);
+      }
+      return result;
+   }
    account_object get_account(string account_name_or_id) const
    {
       FC_ASSERT( account_name_or_id.size() > 0 );
@@ -738,8 +803,12 @@ public:
 
             return *_wallet.my_accounts.get<by_name>().find(account_name_or_id);
          }
+         auto cache_itr = _account_cache.get<by_name>().find(account_name_or_id);
+         if( cache_itr != _account_cache.get<by_name>().end() )
+            return *cache_itr;
          auto rec = _remote_db->lookup_account_names({account_name_or_id}).front();
          FC_ASSERT( rec && rec->name == account_name_or_id );
+         _account_cache.insert(*rec);
          return *rec;
       }
    }
@@ -749,6 +818,9 @@ public:
    }
    optional<asset_object> find_asset(asset_id_type id)const
    {
+      auto cache_itr = _asset_cache.find(id);
+      if( cache_itr != _asset_cache.end() )
+         return cache_itr->second;
       auto rec = _remote_db->get_assets({id}).front();
       if( rec )
          _asset_cache[id] = *rec;
@@ -764,6 +836,9 @@ public:
          return find_asset(*id);
       } else {
          // It's a symbol
+         for( const auto& cached : _asset_cache )
+            if( cached.second.symbol == asset_symbol_or_id )
+               return cached.second;
          auto rec = _remote_db->lookup_asset_symbols({asset_symbol_or_id}).front();
          if( rec )
          {
@@ -910,7 +985,7 @@ public:
 
                         signed_transaction trx;
                         trx.operations = {move_operation};
-                        set_operation_fees( trx, _remote_db->get_global_properties().parameters.current_fees);
+                        set_operation_fees( trx, get_global_properties().parameters.current_fees);
                         trx.validate();
                         ilog("Broadcasting reveal...");
                         trx = sign_transaction(trx, true);
@@ -1126,7 +1201,7 @@ public:
       auto fee_asset_obj = get_asset(fee_asset);
       asset total_fee = fee_asset_obj.amount(0);
 
-      auto gprops = _remote_db->get_global_properties().parameters;
+      auto gprops = get_global_properties().parameters;
       if( fee_asset_obj.get_id() != asset_id_type() )
       {
          for( auto& op : _builder_transactions[handle].operations )
@@ -1168,7 +1243,7 @@ public:
       if( review_period_seconds )
          op.review_period_seconds = review_period_seconds;
       trx.operations = {op};
-      _remote_db->get_global_properties().parameters.current_fees->set_fee( trx.operations.front() );
+      get_global_properties().parameters.current_fees->set_fee( trx.operations.front() );
 
       return trx = sign_transaction(trx, broadcast);
    }
@@ -1189,7 +1264,7 @@ public:
       if( review_period_seconds )
          op.review_period_seconds = review_period_seconds;
       trx.operations = {op};
-      _remote_db->get_global_properties().parameters.current_fees->set_fee( trx.operations.front() );
+      get_global_properties().parameters.current_fees->set_fee( trx.operations.front() );
 
       return trx = sign_transaction(trx, broadcast);
    }
@@ -1239,7 +1314,7 @@ public:
 
       tx.operations.push_back( account_create_op );
 
-      auto current_fees = _remote_db->get_global_properties().parameters.current_fees;
+      auto current_fees = get_global_properties().parameters.current_fees;
       set_operation_fees( tx, current_fees );
 
       vector<public_key_type> paying_keys = registrar_account_object.active.get_keys();
@@ -1280,7 +1355,7 @@ public:
       op.account_to_upgrade = account_obj.get_id();
       op.upgrade_to_lifetime_member = true;
       tx.operations = {op};
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1366,7 +1441,7 @@ public:
 
          tx.operations.push_back( account_create_op );
 
-         set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+         set_operation_fees( tx, get_global_properties().parameters.current_fees);
 
          vector<public_key_type> paying_keys = registrar_account_object.active.get_keys();
 
@@ -1431,7 +1506,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( create_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1460,7 +1535,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1481,7 +1556,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1502,7 +1577,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1526,7 +1601,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1548,7 +1623,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( publish_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1572,7 +1647,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( fund_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1594,7 +1669,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( reserve_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1615,7 +1690,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( settle_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1636,7 +1711,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( settle_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1654,7 +1729,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( whitelist_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1672,7 +1747,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( committee_member_create_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1773,7 +1848,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( witness_create_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       _wallet.pending_witness_registrations[owner_account] = key_to_wif(witness_private_key);
@@ -1802,7 +1877,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( witness_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1853,7 +1928,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1918,7 +1993,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1976,7 +2051,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( vesting_balance_withdraw_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2011,7 +2086,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( account_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2045,7 +2120,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( account_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2086,7 +2161,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( account_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2117,7 +2192,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( account_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2143,13 +2218,20 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( account_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
    } FC_CAPTURE_AND_RETHROW( (account_to_modify)(desired_number_of_witnesses)(desired_number_of_committee_members)(broadcast) ) }
 
    signed_transaction sign_transaction(signed_transaction tx, bool broadcast = false)
+   {
+      flat_set<public_key_type> approving_key_set = get_approving_keys( tx );
+      return sign_transaction( std::move(tx), broadcast, approving_key_set, get_dynamic_global_properties() );
+   }
+
+   /// returns the keys of the accounts and authorities which need to approve @ref tx
+   flat_set<public_key_type> get_approving_keys(const transaction& tx) const
    {
       flat_set<account_id_type> req_active_approvals;
       flat_set<account_id_type> req_owner_approvals;
@@ -2172,7 +2254,7 @@ public:
       /// TODO: fetch the accounts specified via other_auths as well.
 
       vector< optional<account_object> > approving_account_objects =
-            _remote_db->get_accounts( v_approving_account_ids );
+            get_accounts( v_approving_account_ids );
 
       /// TODO: recursively check one layer deeper in the authority tree for keys
 
@@ -2219,8 +2301,13 @@ public:
          for( const auto& k : a.key_auths )
             approving_key_set.insert( k.first );
       }
+      return approving_key_set;
+   }
 
-      auto dyn_props = get_dynamic_global_properties();
+   signed_transaction sign_transaction(signed_transaction tx, bool broadcast,
+                                       const flat_set<public_key_type>& approving_key_set,
+                                       const dynamic_global_property_object& dyn_props)
+   {
       tx.set_reference_block( dyn_props.head_block_id );
 
       // first, some bookkeeping, expire old items from _recently_generated_transactions
@@ -2238,7 +2325,7 @@ public:
          tx.set_expiration( dyn_props.time + fc::seconds(30 + expiration_time_offset) );
          tx.signatures.clear();
 
-         for( public_key_type& key : approving_key_set )
+         for( const public_key_type& key : approving_key_set )
          {
             auto it = _keys.find(key);
             if( it != _keys.end() )
@@ -2285,6 +2372,41 @@ public:
       return tx;
    }
 
+   vector<signed_transaction> broadcast_operations(vector<operation> operations,
+                                                   uint32_t operations_per_transaction,
+                                                   bool broadcast)
+   { try {
+      FC_ASSERT( operations_per_transaction > 0 );
+      auto fees = get_global_properties().parameters.current_fees;
+
+      vector<signed_transaction> result;
+      result.reserve( (operations.size() + operations_per_transaction - 1) / operations_per_transaction );
+
+      // the reference block and expiration of every transaction come from one fetch of the
+      // dynamic global properties, refreshed every few seconds so long batches don't expire
+      dynamic_global_property_object dyn_props = get_dynamic_global_properties();
+      fc::time_point dyn_props_fetched = fc::time_point::now();
+
+      for( size_t start = 0; start < operations.size(); start += operations_per_transaction )
+      {
+         size_t end = std::min<size_t>( operations.size(), start + operations_per_transaction );
+         signed_transaction tx;
+         tx.operations.assign( std::make_move_iterator( operations.begin() + start ),
+                               std::make_move_iterator( operations.begin() + end ) );
+         set_operation_fees( tx, fees );
+         tx.validate();
+         flat_set<public_key_type> approving_key_set = get_approving_keys( tx );
+
+         if( fc::time_point::now() - dyn_props_fetched > fc::seconds(10) )
+         {
+            dyn_props = get_dynamic_global_properties();
+            dyn_props_fetched = fc::time_point::now();
+         }
+         result.push_back( sign_transaction( std::move(tx), broadcast, approving_key_set, dyn_props ) );
+      }
+      return result;
+   } FC_CAPTURE_AND_RETHROW( (operations_per_transaction)(broadcast) ) }
+
    signed_transaction sell_asset(string seller_account,
                                  string amount_to_sell,
                                  string symbol_to_sell,
@@ -2306,7 +2428,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2327,7 +2449,7 @@ public:
 
       signed_transaction trx;
       trx.operations = {op};
-      set_operation_fees( trx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( trx, get_global_properties().parameters.current_fees);
       trx.validate();
       idump((broadcast));
 
@@ -2344,7 +2466,7 @@ public:
          op.fee_paying_account = get_object<limit_order_object>(order_id).seller;
          op.order = order_id;
          trx.operations = {op};
-         set_operation_fees( trx, _remote_db->get_global_properties().parameters.current_fees);
+         set_operation_fees( trx, get_global_properties().parameters.current_fees);
 
          trx.validate();
          return sign_transaction(trx, broadcast);
@@ -2379,7 +2501,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(xfer_op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -2409,7 +2531,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(issue_op);
-      set_operation_fees(tx,_remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees(tx,get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -3158,6 +3280,16 @@ public:
    const string _wallet_filename_extension = ".wallet";
 
    mutable map<asset_id_type, asset_object> _asset_cache;
+
+   typedef multi_index_container<
+      account_object,
+      indexed_by<
+         ordered_unique< tag<by_id>, member< object, object_id_type, &object::id > >,
+         ordered_unique< tag<by_name>, member< account_object, string, &account_object::name > > > > account_cache_type;
+   /// accounts other than my_accounts looked up by this wallet, refreshed by subscribed_object_changed()
+   mutable account_cache_type _account_cache;
+
+   mutable optional<global_property_object> _global_properties_cache;
 };
 
 std::string operation_printer::fee(const asset& a)const {
@@ -3946,6 +4078,13 @@ signed_transaction wallet_api::sign_transaction(signed_transaction tx, bool broa
    return my->sign_transaction( tx, broadcast);
 } FC_CAPTURE_AND_RETHROW( (tx) ) }
 
+vector<signed_transaction> wallet_api::broadcast_operations(vector<operation> operations,
+                                                       uint32_t operations_per_transaction,
+                                                       bool broadcast /* = true */)
+{
+   return my->broadcast_operations( std::move(operations), operations_per_transaction, broadcast );
+}
+
 operation wallet_api::get_prototype_operation(string operation_name)
 {
    return my->get_prototype_operation( operation_name );
@@ -4293,7 +4432,7 @@ vector< signed_transaction > wallet_api_impl::import_balance( string name_or_id,
       tx.operations.reserve( ctx.ops.size() );
       for( const balance_claim_operation& op : ctx.ops )
          tx.operations.emplace_back( op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
       signed_transaction signed_tx = sign_transaction( tx, false );
       for( const address& addr : ctx.addrs )
@@ -4488,7 +4627,7 @@ blind_confirmation wallet_api::transfer_from_blind( string from_blind_account_ke
    transfer_from_blind_operation from_blind;
 
 
-   auto fees  = my->_remote_db->get_global_properties().parameters.current_fees;
+   auto fees  = my->get_global_properties().parameters.current_fees;
    fc::optional<asset_object> asset_obj = get_asset(symbol);
    FC_ASSERT(asset_obj.valid(), "Could not find asset matching ${asset}", ("asset", symbol));
    auto amount = asset_obj->amount_from_string(amount_in);
@@ -4566,7 +4705,7 @@ blind_confirmation wallet_api::blind_transfer_help( string from_key_or_label,
    blind_transfer_operation blind_tr;
    blind_tr.outputs.resize(2);
 
-   auto fees  = my->_remote_db->get_global_properties().parameters.current_fees;
+   auto fees  = my->get_global_properties().parameters.current_fees;
 
    auto amount = asset_obj->amount_from_string(amount_in);
 
@@ -4788,7 +4927,7 @@ blind_confirmation wallet_api::transfer_to_blind( string from_account_id_or_name
               [&]( const blind_output& a, const blind_output& b ){ return a.commitment < b.commitment; } );
 
    confirm.trx.operations.push_back( bop );
-   my->set_operation_fees( confirm.trx, my->_remote_db->get_global_properties().parameters.current_fees);
+   my->set_operation_fees( confirm.trx, my->get_global_properties().parameters.current_fees);
    confirm.trx.validate();
    confirm.trx = sign_transaction(confirm.trx, broadcast);
 
@@ -4907,7 +5046,7 @@ signed_transaction wallet_api::tournament_create( string creator, tournament_opt
    op.creator = creator_account_obj.get_id();
    op.options = options;
    tx.operations = {op};
-   my->set_operation_fees( tx, my->_remote_db->get_global_properties().parameters.current_fees );
+   my->set_operation_fees( tx, my->get_global_properties().parameters.current_fees );
    tx.validate();
 
    return my->sign_transaction( tx, broadcast );
@@ -4936,7 +5075,7 @@ signed_transaction wallet_api::tournament_join( string payer_account,
    op.buy_in = buy_in_asset_obj->amount_from_string(buy_in_amount);
 
    tx.operations = {op};
-   my->set_operation_fees( tx, my->_remote_db->get_global_properties().parameters.current_fees );
+   my->set_operation_fees( tx, my->get_global_properties().parameters.current_fees );
    tx.validate();
 
    return my->sign_transaction( tx, broadcast );
@@ -4959,7 +5098,7 @@ signed_transaction wallet_api::tournament_leave( string canceling_account,
     op.tournament_id = tournament_id;
 
     tx.operations = {op};
-    my->set_operation_fees( tx, my->_remote_db->get_global_properties().parameters.current_fees );
+    my->set_operation_fees( tx, my->get_global_properties().parameters.current_fees );
     tx.validate();
 
     return my->sign_transaction( tx, broadcast );
@@ -5030,7 +5169,7 @@ signed_transaction wallet_api::rps_throw(game_id_type game_id,
    move_operation.player_account_id = player_account_obj.id;
    move_operation.move = commit_throw;
    tx.operations = {move_operation};
-   my->set_operation_fees( tx, my->_remote_db->get_global_properties().parameters.current_fees );
+   my->set_operation_fees( tx, my->get_global_properties().parameters.current_fees );
    tx.validate();
 
    return my->sign_transaction( tx, broadcast );
@@ -32,8 +32,23 @@
 
 #include <boost/test/auto_unit_test.hpp>
 
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
+
 using namespace graphene::chain;
 
+/** peak resident set size of this process in kilobytes, or 0 where it can't be queried */
+static int64_t peak_rss_kb()
+{
+#ifndef WIN32
+   struct rusage usage;
+   if( getrusage( RUSAGE_SELF, &usage ) == 0 )
+      return usage.ru_maxrss;
+#endif
+   return 0;
+}
+
 BOOST_AUTO_TEST_CASE( operation_sanity_check )
 {
    try {
@@ -47,6 +62,64 @@ BOOST_AUTO_TEST_CASE( operation_sanity_check )
    }
 }
 
+template<typename Index>
+static int64_t time_name_lookups( const Index& index, const vector<string>& names )
+{
+   uint64_t found = 0;
+   auto start = fc::time_point::now();
+   for( const string& name : names )
+      found += index.find( name )->id.instance();
+   auto elapsed = fc::time_point::now() - start;
+   BOOST_CHECK( found > 0 );
+   return elapsed.count() * 1000 / int64_t( names.size() );
+}
+
+BOOST_AUTO_TEST_CASE( account_name_lookup_bench )
+{
+   try {
+      genesis_state_type genesis_state;
+
+#ifdef NDEBUG
+      const int account_count = 2000000;
+#else
+      const int account_count = 30000;
+#endif
+      const int lookup_count = 2000000;
+
+      for( int i = 0; i < account_count; ++i )
+         genesis_state.initial_accounts.emplace_back("target"+fc::to_string(i),
+                                                     public_key_type(fc::ecc::private_key::regenerate(fc::digest(i)).get_public_key()));
+
+      fc::temp_directory data_dir( graphene::utilities::temp_directory_path() );
+      database db;
+      db.open(data_dir.path(), [&]{return genesis_state;});
+
+      vector<string> names;
+      names.reserve( lookup_count );
+      for( int i = 0; i < lookup_count; ++i )
+         names.push_back( "target" + fc::to_string( (i * 7919) % account_count ) );
+
+      const auto& accounts = db.get_index_type<account_index>().indices();
+      int64_t ordered_ns = time_name_lookups( accounts.get<by_name>(), names );
+      int64_t hashed_ns = time_name_lookups( accounts.get<by_name_hash>(), names );
+      ilog("Resolved ${n} names among ${c} accounts: ${o} ns ordered, ${h} ns hashed per lookup.",
+           ("n", lookup_count)("c", account_count)("o", ordered_ns)("h", hashed_ns));
+
+      // the walk maintenance makes over every account
+      uint64_t votes = 0;
+      auto start_time = fc::time_point::now();
+      for( const account_object& a : accounts.get<by_name>() )
+         votes += a.options.votes.size();
+      ilog("Iterated ${c} accounts (${v} votes) in name order in ${t} milliseconds.",
+           ("c", accounts.size())("v", votes)("t", (fc::time_point::now() - start_time).count() / 1000));
+
+      db.close();
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( genesis_and_persistence_bench )
 {
    try {
@@ -70,12 +143,15 @@ BOOST_AUTO_TEST_CASE( genesis_and_persistence_bench )
 
       {
          database db;
+         fc::time_point start_time = fc::time_point::now();
          db.open(data_dir.path(), [&]{return genesis_state;});
+         ilog("Initialized genesis with ${c} accounts in ${t} milliseconds, peak RSS ${m} kB.",
+              ("c", account_count)("t", (fc::time_point::now() - start_time).count() / 1000)("m", peak_rss_kb()));
 
          for( int i = 11; i < account_count + 11; ++i)
             BOOST_CHECK(db.get_balance(account_id_type(i), asset_id_type()).amount == GRAPHENE_MAX_SHARE_SUPPLY / account_count);
 
-         fc::time_point start_time = fc::time_point::now();
+         start_time = fc::time_point::now();
          db.close();
          ilog("Closed database in ${t} milliseconds.", ("t", (fc::time_point::now() - start_time).count() / 1000));
       }
@@ -23,6 +23,7 @@
  */
 #include <boost/test/unit_test.hpp>
 #include <boost/program_options.hpp>
+#include <boost/range/iterator_range.hpp>
 
 #include <graphene/account_history/account_history_plugin.hpp>
 #include <graphene/market_history/market_history_plugin.hpp>
@@ -428,7 +429,7 @@ const asset_object& database_fixture::get_asset( const string& symbol )const
 
 const account_object& database_fixture::get_account( const string& name )const
 {
-   const auto& idx = db.get_index_type<account_index>().indices().get<by_name>();
+   const auto& idx = db.get_index_type<account_index>().indices().get<by_name_hash>();
    const auto itr = idx.find(name);
    assert( itr != idx.end() );
    return *itr;
@@ -902,6 +903,45 @@ void database_fixture::enable_fees()
    });
 }
 
+vector<uint64_t> database_fixture::name_order_vote_tally()
+{
+   const global_property_object& gpo = db.get_global_properties();
+   vector<uint64_t> tally( gpo.next_available_vote_id );
+   auto session = db._undo_db.start_undo_session();
+
+   map<account_id_type, share_type> vesting_amounts;
+   const auto& vesting_index = db.get_index_type<vesting_balance_index>().indices().get<by_asset_balance>();
+   auto vesting_begin = vesting_index.lower_bound( boost::make_tuple( asset_id_type() ) );
+   auto vesting_end = vesting_index.upper_bound( boost::make_tuple( asset_id_type(), share_type() ) );
+   for( const vesting_balance_object& vb : boost::make_iterator_range( vesting_begin, vesting_end ) )
+      vesting_amounts[vb.owner] += vb.balance.amount;
+
+   for( const account_object& a : db.get_index_type<account_index>().indices().get<by_name>() )
+   {
+      if( gpo.parameters.count_non_member_votes || a.is_member( db.head_block_time() ) )
+      {
+         const account_object* opinion = a.options.voting_account == GRAPHENE_PROXY_TO_SELF_ACCOUNT
+                                            ? &a : db.find( a.options.voting_account );
+         if( opinion != nullptr )
+         {
+            uint64_t stake = a.statistics(db).total_core_in_orders.value
+                  + (a.cashback_vb.valid() ? (*a.cashback_vb)(db).balance.amount.value : 0)
+                  + db.get_balance( a.get_id(), asset_id_type() ).amount.value;
+            auto itr = vesting_amounts.find( a.id );
+            if( itr != vesting_amounts.end() )
+               stake += itr->second.value;
+            for( vote_id_type id : opinion->options.votes )
+               if( id.instance() < tally.size() )
+                  tally[id.instance()] += stake;
+         }
+      }
+      a.statistics(db).process_fees( a, db );
+   }
+
+   session.undo();
+   return tally;
+}
+
 void database_fixture::upgrade_to_lifetime_member(account_id_type account)
 {
    upgrade_to_lifetime_member(account(db));
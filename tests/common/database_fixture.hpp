@@ -273,6 +273,12 @@ struct database_fixture {
    void upgrade_to_lifetime_member( const account_object& account );
    void upgrade_to_annual_member( account_id_type account );
    void upgrade_to_annual_member( const account_object& account );
+   /**
+    * The tally perform_chain_maintenance() used to run, kept as a reference: account by account in name order,
+    * the votes are counted and then the fees processed.  The fee processing is undone afterwards.
+    * @return the stake voting for each vote id instance
+    */
+   vector<uint64_t> name_order_vote_tally();
    void print_market( const string& syma, const string& symb )const;
    string pretty( const asset& a )const;
    void print_limit_order( const limit_order_object& cur )const;
@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+
+# Measures how many transactions per second a scripted payout gets through the
+# wallet.  Start a cli_wallet with an unlocked wallet holding the payer's key
+# and an RPC endpoint, e.g.
+#
+#    cli_wallet -s ws://127.0.0.1:8090 -r 127.0.0.1:8091
+#
+# then run
+#
+#    wallet_payout.py <payer> <first recipient account id> [count]
+#
+# which pays 1 satoshi of the core asset to <count> consecutive account ids,
+# first one transfer call at a time for a sample, then through
+# broadcast_operations.
+
+import json
+import sys
+import time
+
+try:
+    import asyncio
+except ImportError:
+    print("asyncio module not found (try pip install asyncio, or upgrade to Python 3.4 or later)")
+    sys.exit(1)
+
+try:
+    import websockets
+except ImportError:
+    print("websockets module not found (try pip install websockets)")
+    sys.exit(1)
+
+WALLET_URL = 'ws://127.0.0.1:8091/'
+SINGLE_TRANSFER_SAMPLE = 200
+OPERATIONS_PER_TRANSACTION = 1
+
+next_call_id = 0
+
+async def call(ws, method, *params):
+    global next_call_id
+    next_call_id += 1
+    call_id = next_call_id
+    await ws.send(json.dumps({"jsonrpc": "2.0", "id": call_id, "method": method, "params": list(params)}))
+    reply = json.loads(await ws.recv())
+    if "error" in reply:
+        raise RuntimeError(reply["error"])
+    return reply["result"]
+
+def transfer_op(payer_id, recipient_id):
+    return [0, {"fee": {"amount": 0, "asset_id": "1.3.0"},
+                "from": payer_id,
+                "to": recipient_id,
+                "amount": {"amount": 1, "asset_id": "1.3.0"},
+                "extensions": []}]
+
+async def mainloop(payer, first_recipient, count):
+    async with websockets.connect(WALLET_URL, max_size=None) as ws:
+        payer_id = (await call(ws, "get_account", payer))["id"]
+        space, kind, instance = first_recipient.split(".")
+        recipients = [space + "." + kind + "." + str(int(instance) + i) for i in range(count)]
+
+        sample = recipients[:SINGLE_TRANSFER_SAMPLE]
+        start = time.time()
+        for recipient in sample:
+            await call(ws, "transfer", payer, recipient, "0.00001", "1.3.0", "", True)
+        elapsed = time.time() - start
+        print("transfer:             %d transactions in %.2f s, %.1f tx/s" % (len(sample), elapsed, len(sample) / elapsed))
+
+        ops = [transfer_op(payer_id, recipient) for recipient in recipients]
+        start = time.time()
+        trxs = await call(ws, "broadcast_operations", ops, OPERATIONS_PER_TRANSACTION, True)
+        elapsed = time.time() - start
+        print("broadcast_operations: %d transactions in %.2f s, %.1f tx/s" % (len(trxs), elapsed, len(trxs) / elapsed))
+
+if len(sys.argv) < 3:
+    print("usage: %s <payer> <first recipient account id> [count]" % sys.argv[0])
+    sys.exit(1)
+
+asyncio.get_event_loop().run_until_complete(
+    mainloop(sys.argv[1], sys.argv[2], int(sys.argv[3]) if len(sys.argv) > 3 else 10000))
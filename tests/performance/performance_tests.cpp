@@ -23,20 +23,56 @@
  */
 #include <boost/test/unit_test.hpp>
 
+#include <graphene/app/database_api.hpp>
+
 #include <graphene/chain/database.hpp>
+#include <graphene/chain/exceptions.hpp>
+#include <graphene/chain/fork_database.hpp>
 #include <graphene/chain/protocol/protocol.hpp>
 
 #include <graphene/chain/account_object.hpp>
 #include <graphene/chain/asset_object.hpp>
+#include <graphene/chain/committee_member_object.hpp>
+#include <graphene/chain/market_object.hpp>
 #include <graphene/chain/proposal_object.hpp>
+#include <graphene/chain/transaction_object.hpp>
+#include <graphene/chain/witness_object.hpp>
 
+#include <graphene/db/pack_buffer.hpp>
 #include <graphene/db/simple_index.hpp>
 
+#include <graphene/utilities/tempdir.hpp>
+
 #include <fc/crypto/digest.hpp>
+#include <fc/io/json.hpp>
+#include <fc/thread/thread.hpp>
+
 #include "../common/database_fixture.hpp"
 
+#include <fstream>
+#include <functional>
+#include <random>
+#include <thread>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
 using namespace graphene::chain;
 
+// resident set size of this process in kilobytes, 0 where it cannot be read
+static uint64_t resident_memory_kb()
+{
+#ifdef __linux__
+   std::ifstream statm( "/proc/self/statm" );
+   uint64_t total_pages = 0;
+   uint64_t resident_pages = 0;
+   statm >> total_pages >> resident_pages;
+   return resident_pages * uint64_t( sysconf( _SC_PAGESIZE ) ) / 1024;
+#else
+   return 0;
+#endif
+}
+
 //BOOST_FIXTURE_TEST_SUITE( performance_tests, database_fixture )
 
 BOOST_AUTO_TEST_CASE( sigcheck_benchmark )
@@ -51,6 +87,1023 @@ BOOST_AUTO_TEST_CASE( sigcheck_benchmark )
    auto elapsed = end-start;
    wdump( ((100000.0*1000000.0) / elapsed.count()) );
 }
+BOOST_FIXTURE_TEST_CASE( subscription_dispatch_benchmark, database_fixture )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t subscriber_count = 5000;
+      const uint32_t blocks_to_produce = 100;
+#else
+      const uint32_t subscriber_count = 500;
+      const uint32_t blocks_to_produce = 10;
+#endif
+      const uint32_t transfers_per_block = 20;
+
+      ACTORS( (alice)(bob) );
+      fund( alice, asset(10000000) );
+
+      // every client subscribes the way wallets do: a subscribe callback plus a get_objects call
+      uint64_t notifications = 0;
+      vector< std::shared_ptr<graphene::app::database_api> > apis;
+      apis.reserve( subscriber_count );
+      for( uint32_t i = 0; i < subscriber_count; ++i )
+      {
+         auto api = std::make_shared<graphene::app::database_api>( std::ref(db) );
+         api->set_subscribe_callback( [&notifications]( const fc::variant& ){ ++notifications; }, false );
+         api->get_objects( { alice_id, bob_id } );
+         apis.push_back( api );
+      }
+
+      auto start = fc::time_point::now();
+      for( uint32_t i = 0; i < blocks_to_produce; ++i )
+      {
+         for( uint32_t j = 0; j < transfers_per_block; ++j )
+            transfer( alice_id, bob_id, asset(1) );
+         generate_block();
+         fc::yield();
+      }
+      auto elapsed = fc::time_point::now() - start;
+
+      BOOST_CHECK( notifications > 0 );
+      ilog( "Dispatched ${n} notifications to ${s} subscribers over ${b} blocks in ${t} milliseconds.",
+            ("n", notifications)("s", subscriber_count)("b", blocks_to_produce)("t", elapsed.count() / 1000) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( get_full_accounts_benchmark, database_fixture )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t account_count = 10000;
+      const uint32_t polls = 100000;
+#else
+      const uint32_t account_count = 1000;
+      const uint32_t polls = 10000;
+#endif
+      // wallets poll a small set of accounts constantly; every 10th poll asks for one of the others
+      const uint32_t hot_account_count = 20;
+
+      vector<string> names;
+      for( uint32_t i = 0; i < account_count; ++i )
+      {
+         names.push_back( "poller" + fc::to_string(i) );
+         create_account( names.back() );
+      }
+      generate_block();
+
+      graphene::app::database_api db_api( db );
+
+      auto start = fc::time_point::now();
+      for( uint32_t i = 0; i < polls; ++i )
+      {
+         const string& name = ( i % 10 == 9 ) ? names[ std::rand() % account_count ]
+                                              : names[ i % hot_account_count ];
+         auto result = db_api.get_full_accounts( { name }, false );
+         BOOST_REQUIRE_EQUAL( result.size(), 1 );
+         if( i % 1000 == 0 )
+         {
+            // changes made through a block must show up in the next poll
+            transfer( committee_account, get_account( names[0] ).id, asset(1) );
+            generate_block();
+            BOOST_CHECK_EQUAL( db_api.get_full_accounts( { names[0] }, false )[ names[0] ].balances[0].balance.value,
+                               get_balance( get_account( names[0] ).id, asset_id_type() ) );
+         }
+      }
+      auto elapsed = fc::time_point::now() - start;
+
+      ilog( "Answered ${p} get_full_accounts polls (${h} hot accounts, ${c} accounts total) in ${t} milliseconds.",
+            ("p", polls)("h", hot_account_count)("c", account_count)("t", elapsed.count() / 1000) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( fork_database_benchmark )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t block_count = 1000000;
+#else
+      const uint32_t block_count = 100000;
+#endif
+      const uint32_t pop_count = 1000;
+
+      // every block carries one transfer so the fork database holds more than bare headers
+      processed_transaction trx;
+      trx.operations.emplace_back( transfer_operation() );
+
+      fork_database fdb;
+      uint64_t rss_before = resident_memory_kb();
+      uint64_t rss_peak = rss_before;
+
+      block_id_type previous;
+      auto start = fc::time_point::now();
+      for( uint32_t i = 0; i < block_count; ++i )
+      {
+         signed_block b;
+         b.previous = previous;
+         b.transactions.push_back( trx );
+         previous = fdb.push_block( std::move(b) )->id;
+         if( i % 100000 == 0 )
+            rss_peak = std::max( rss_peak, resident_memory_kb() );
+      }
+      auto push_elapsed = fc::time_point::now() - start;
+      BOOST_CHECK_EQUAL( fdb.head()->num, block_count );
+
+      start = fc::time_point::now();
+      for( uint32_t i = 0; i < pop_count; ++i )
+         fdb.pop_block();
+      auto pop_elapsed = fc::time_point::now() - start;
+      BOOST_CHECK_EQUAL( fdb.head()->num, block_count - pop_count );
+
+      ilog( "Pushed ${n} blocks into the fork database in ${t} milliseconds, ${r} blocks/s; popped ${p} in ${pt} microseconds",
+            ("n", block_count)("t", push_elapsed.count() / 1000)
+            ("r", uint64_t(block_count) * 1000000 / std::max<int64_t>( push_elapsed.count(), 1 ))
+            ("p", pop_count)("pt", pop_elapsed.count()) );
+      ilog( "Resident memory: ${b} KiB before, ${p} KiB peak during the sync",
+            ("b", rss_before)("p", rss_peak) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( block_catch_up_benchmark, database_fixture )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t blocks_to_produce = 10000;
+#else
+      const uint32_t blocks_to_produce = 1000;
+#endif
+      const uint32_t transfers_per_block = 10;
+      const uint32_t blocks_per_request = 200;
+
+      ACTORS( (alice)(bob) );
+      fund( alice, asset(10000000) );
+      for( uint32_t i = 0; i < blocks_to_produce; ++i )
+      {
+         for( uint32_t j = 0; j < transfers_per_block; ++j )
+            transfer( alice_id, bob_id, asset(1) );
+         generate_block();
+      }
+      const uint32_t head = db.head_block_num();
+
+      graphene::app::database_api db_api( db );
+
+      // a delayed node catching up through the JSON encoding of the wire, first block by block with
+      // get_block, then in batches of packed blocks with get_blocks
+      fc::temp_directory by_block_dir( graphene::utilities::temp_directory_path() );
+      database by_block;
+      by_block.open( by_block_dir.path(), [this]{ return genesis_state; } );
+      auto start = fc::time_point::now();
+      for( uint32_t num = 1; num <= head; ++num )
+      {
+         fc::variant reply = fc::json::from_string( fc::json::to_string( db_api.get_block( num ) ) );
+         by_block.push_block( reply.as<signed_block>() );
+      }
+      auto by_block_elapsed = fc::time_point::now() - start;
+      BOOST_CHECK( by_block.head_block_id() == db.head_block_id() );
+
+      fc::temp_directory batched_dir( graphene::utilities::temp_directory_path() );
+      database batched;
+      batched.open( batched_dir.path(), [this]{ return genesis_state; } );
+      start = fc::time_point::now();
+      while( batched.head_block_num() < head )
+      {
+         fc::variant reply = fc::json::from_string( fc::json::to_string(
+               db_api.get_blocks( batched.head_block_num() + 1, blocks_per_request ) ) );
+         auto packed_blocks = reply.as< vector<vector<char>> >();
+         BOOST_REQUIRE( !packed_blocks.empty() );
+         for( const vector<char>& packed_block : packed_blocks )
+            batched.push_block( fc::raw::unpack<signed_block>( packed_block ) );
+      }
+      auto batched_elapsed = fc::time_point::now() - start;
+      BOOST_CHECK( batched.head_block_id() == db.head_block_id() );
+
+      ilog( "Caught up ${n} blocks with get_block in ${t} milliseconds, ${r} blocks/s",
+            ("n", head)("t", by_block_elapsed.count() / 1000)
+            ("r", uint64_t(head) * 1000000 / std::max<int64_t>( by_block_elapsed.count(), 1 )) );
+      ilog( "Caught up ${n} blocks with get_blocks in ${t} milliseconds, ${r} blocks/s",
+            ("n", head)("t", batched_elapsed.count() / 1000)
+            ("r", uint64_t(head) * 1000000 / std::max<int64_t>( batched_elapsed.count(), 1 )) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( vote_tally_benchmark, database_fixture )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t account_count = 1000000;
+#else
+      const uint32_t account_count = 20000;
+#endif
+      const uint32_t accounts_per_block = 1000;
+
+      // make_account() votes for random committee members, the transfers give every voter a different stake
+      for( uint32_t i = 0; i < account_count; ++i )
+      {
+         signed_transaction create_trx;
+         set_expiration( db, create_trx );
+         create_trx.operations.push_back( make_account( "voter" + fc::to_string(i) ) );
+         processed_transaction ptx = db.push_transaction( create_trx, ~0 );
+
+         signed_transaction fund_trx;
+         set_expiration( db, fund_trx );
+         transfer_operation op;
+         op.to = ptx.operation_results[0].get<object_id_type>();
+         op.amount = asset( 1000 + i % 1000 );
+         fund_trx.operations.push_back( op );
+         db.push_transaction( fund_trx, ~0 );
+
+         if( i % accounts_per_block == accounts_per_block - 1 )
+            generate_block();
+      }
+
+      // a lifetime member sorting in between the voters refers accounts paying fees, so it receives cashback
+      // in the middle of the name order pass
+      const account_object& referrer = create_account( "voter5-referrer" );
+      const account_id_type referrer_id = referrer.id;
+      upgrade_to_lifetime_member( referrer );
+      fund( referrer, asset(10000000) );
+      {
+         account_update_operation op;
+         op.account = referrer_id;
+         op.new_options = referrer.options;
+         op.new_options->votes.insert( witness_id_type(1)(db).vote_id );
+         trx.operations.push_back( op );
+         PUSH_TX( db, trx, ~0 );
+         trx.operations.clear();
+      }
+      vector<account_id_type> referred;
+      for( uint32_t i = 0; i < 100; ++i )
+      {
+         const account_object& a = create_account( "referred" + fc::to_string(i), referrer_id(db), referrer_id(db), 50 );
+         referred.push_back( a.id );
+         fund( a, asset(1000000) );
+      }
+      enable_fees();
+      for( account_id_type id : referred )
+         transfer( id, referrer_id, asset(1000) );
+      generate_block();
+
+      generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+      signed_block maintenance_block = *db.fetch_block_by_number( db.head_block_num() );
+      db.pop_block();
+      const vector<uint64_t> reference = name_order_vote_tally();
+
+      auto apply_maintenance_block = [&]( uint32_t threads ) {
+         if( db.head_block_num() == maintenance_block.block_num() )
+            db.pop_block();
+         db.node_properties().maintenance_threads = threads;
+         auto start = fc::time_point::now();
+         PUSH_BLOCK( db, maintenance_block, ~0 );
+         return fc::time_point::now() - start;
+      };
+      // the tallies the maintenance block stored, against the old interleaved name order tally
+      auto matches_reference = [&]() -> bool {
+         for( const witness_object& wit : db.get_index_type<witness_index>().indices() )
+            if( wit.total_votes != reference[wit.vote_id.instance()] )
+               return false;
+         for( committee_member_id_type id : db.get_global_properties().active_committee_members )
+            if( id(db).total_votes != reference[id(db).vote_id.instance()] )
+               return false;
+         return true;
+      };
+
+      auto single_threaded_elapsed = apply_maintenance_block( 1 );
+      BOOST_CHECK( matches_reference() );
+      auto multi_threaded_elapsed = apply_maintenance_block( 0 );
+      BOOST_CHECK( matches_reference() );
+      BOOST_CHECK_GT( witness_id_type(1)(db).total_votes, 0u );
+
+      ilog( "Maintenance block with ${n} accounts: ${s} milliseconds on one thread, ${m} milliseconds on ${t} threads",
+            ("n", account_count)("s", single_threaded_elapsed.count() / 1000)
+            ("m", multi_threaded_elapsed.count() / 1000)("t", std::thread::hardware_concurrency()) );
+   } FC_LOG_AND_RETHROW()
+}
+
+template<typename Index>
+static void benchmark_get_by_id( const char* name, uint32_t object_count, const vector<account_balance_id_type>& lookups )
+{
+   database db;
+   Index idx( db );
+   for( uint32_t i = 0; i < object_count; ++i )
+      idx.create( [i]( object& o ) {
+         account_balance_object& b = static_cast<account_balance_object&>( o );
+         b.owner = account_id_type( i );
+         b.balance = i;
+      });
+
+   int64_t sum = 0;
+   auto start = fc::time_point::now();
+   for( const account_balance_id_type& id : lookups )
+      sum += static_cast<const account_balance_object&>( idx.get( id ) ).balance.value;
+   auto elapsed = fc::time_point::now() - start;
+
+   BOOST_CHECK( sum > 0 );
+   ilog( "${name}: ${n} lookups among ${c} objects in ${t} milliseconds, ${ns} ns per lookup",
+         ("name", name)("n", lookups.size())("c", object_count)("t", elapsed.count() / 1000)
+         ("ns", elapsed.count() * 1000 / int64_t( lookups.size() )) );
+}
+
+BOOST_AUTO_TEST_CASE( dense_index_get_by_id_benchmark )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t object_count = 10000000;
+#else
+      const uint32_t object_count = 100000;
+#endif
+      const uint32_t lookup_count = 10000000;
+
+      std::mt19937 rng( 1 );
+      std::uniform_int_distribution<uint32_t> instance( 0, object_count - 1 );
+      vector<account_balance_id_type> lookups;
+      lookups.reserve( lookup_count );
+      for( uint32_t i = 0; i < lookup_count; ++i )
+         lookups.push_back( account_balance_id_type( instance( rng ) ) );
+
+      // the same multi_index container, once found through its by_id tree and once through the dense table
+      benchmark_get_by_id< primary_index< generic_index< account_balance_object, account_balance_object_multi_index_type > > >(
+         "generic_index", object_count, lookups );
+      benchmark_get_by_id< primary_index< account_balance_index > >( "dense_index", object_count, lookups );
+   } FC_LOG_AND_RETHROW()
+}
+
+// nanoseconds per lookup of the given (account, asset) keys
+template<typename Index>
+static int64_t time_balance_lookups( const Index& index, const vector< std::pair<account_id_type, asset_id_type> >& keys )
+{
+   int64_t sum = 0;
+   auto start = fc::time_point::now();
+   for( const auto& key : keys )
+      sum += index.find( boost::make_tuple( key.first, key.second ) )->balance.value;
+   auto elapsed = fc::time_point::now() - start;
+   BOOST_CHECK( sum > 0 );
+   return elapsed.count() * 1000 / int64_t( keys.size() );
+}
+
+BOOST_AUTO_TEST_CASE( balance_lookup_benchmark )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t account_count = 1000000;
+#else
+      const uint32_t account_count = 50000;
+#endif
+      const uint32_t assets_per_account = 3;
+      const uint32_t lookup_count = 5000000;
+
+      database db;
+      for( uint32_t i = 0; i < account_count; ++i )
+         for( uint32_t a = 0; a < assets_per_account; ++a )
+            db.create<account_balance_object>( [&]( account_balance_object& b ) {
+               b.owner = account_id_type( i );
+               b.asset_type = asset_id_type( a );
+               b.balance = i + a + 1;
+            });
+
+      std::mt19937 rng( 1 );
+      std::uniform_int_distribution<uint32_t> account( 0, account_count - 1 );
+      std::uniform_int_distribution<uint32_t> asset_type( 0, assets_per_account - 1 );
+      vector< std::pair<account_id_type, asset_id_type> > keys;
+      keys.reserve( lookup_count );
+      for( uint32_t i = 0; i < lookup_count; ++i )
+         keys.emplace_back( account_id_type( account( rng ) ), asset_id_type( asset_type( rng ) ) );
+
+      const auto& balances = db.get_index_type<account_balance_index>().indices();
+      int64_t ordered_ns = time_balance_lookups( balances.get<by_account_asset>(), keys );
+      int64_t hashed_ns = time_balance_lookups( balances.get<by_account_asset_hash>(), keys );
+
+      ilog( "Balance lookups among ${n} balances: ${o} ns ordered, ${h} ns hashed",
+            ("n", account_count * assets_per_account)("o", ordered_ns)("h", hashed_ns) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( transfer_throughput_benchmark, database_fixture )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t transfer_count = 200000;
+#else
+      const uint32_t transfer_count = 20000;
+#endif
+      const uint32_t transfers_per_block = 1000;
+
+      ACTORS( (alice)(bob) );
+      fund( alice, asset(100000000) );
+      generate_block();
+
+      auto start = fc::time_point::now();
+      for( uint32_t i = 0; i < transfer_count; ++i )
+      {
+         signed_transaction tx;
+         transfer_operation op;
+         op.from = (i & 1) ? bob_id : alice_id;
+         op.to = (i & 1) ? alice_id : bob_id;
+         op.fee = asset(1);
+         op.amount = asset( 1 + i % 1000 );
+         tx.operations.push_back( op );
+         tx.expiration = db.head_block_time() + fc::seconds( 60 + i % 3000 );
+         db.push_transaction( tx, ~0 );
+         if( i % transfers_per_block == transfers_per_block - 1 )
+            generate_block();
+      }
+      auto elapsed = fc::time_point::now() - start;
+
+      ilog( "Pushed and produced ${n} transfers in ${t} milliseconds, ${r} transfers/s",
+            ("n", transfer_count)("t", elapsed.count() / 1000)
+            ("r", uint64_t(transfer_count) * 1000000 / std::max<int64_t>( elapsed.count(), 1 )) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( evaluation_object_cache_benchmark, database_fixture )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t op_count = 100000;
+#else
+      const uint32_t op_count = 10000;
+#endif
+      const uint32_t ops_per_block = 1000;
+
+      ACTORS( (alice)(bob) );
+      const asset_id_type test_id = create_user_issued_asset( "TESTUIA" ).id;
+      fund( alice, asset(100000000) );
+      fund( bob, asset(100000000) );
+      issue_uia( bob_id, asset( 100000000, test_id ) );
+      generate_block();
+
+      auto run = [&]( const char* kind, std::function<operation(uint32_t)> make_op )
+      {
+         const evaluation_cache_stats before = db.get_evaluation_cache_stats();
+         auto start = fc::time_point::now();
+         for( uint32_t i = 0; i < op_count; ++i )
+         {
+            signed_transaction tx;
+            tx.operations.push_back( make_op( i ) );
+            tx.expiration = db.head_block_time() + fc::seconds( 60 + i % 3000 );
+            db.push_transaction( tx, ~0 );
+            if( i % ops_per_block == ops_per_block - 1 )
+               generate_block();
+         }
+         auto elapsed = fc::time_point::now() - start;
+         const evaluation_cache_stats& after = db.get_evaluation_cache_stats();
+
+         ilog( "${n} ${k} in ${t} milliseconds, ${l} object lookups per operation, ${h} of them cached",
+               ("n", op_count)("k", kind)("t", elapsed.count() / 1000)
+               ("l", double( after.lookups - before.lookups ) / op_count)
+               ("h", double( after.hits - before.hits ) / op_count) );
+      };
+
+      run( "transfers", [&]( uint32_t i ) -> operation {
+         transfer_operation op;
+         op.from = (i & 1) ? bob_id : alice_id;
+         op.to = (i & 1) ? alice_id : bob_id;
+         op.fee = asset(1);
+         op.amount = asset( 1 + i % 1000 );
+         return op;
+      } );
+
+      // alternate sides so the orders keep filling each other
+      run( "limit orders", [&]( uint32_t i ) -> operation {
+         limit_order_create_operation op;
+         op.fee = asset(1);
+         op.seller = (i & 1) ? bob_id : alice_id;
+         op.amount_to_sell = (i & 1) ? asset( 10, test_id ) : asset( 10 );
+         op.min_to_receive = (i & 1) ? asset( 10 ) : asset( 10, test_id );
+         op.expiration = db.head_block_time() + fc::days( 1 ) + fc::seconds( i );
+         return op;
+      } );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( transaction_dedupe_sustained_load_benchmark, database_fixture )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t expiration_window = 600;
+#else
+      const uint32_t expiration_window = 60;
+#endif
+      const uint32_t transactions_per_second = 1000;
+
+      ACTORS( (alice)(bob) );
+      fund( alice, asset(1000000000) );
+      generate_block();
+
+      // run twice the expiration window, so that the dedupe index reaches its steady state halfway through
+      const uint32_t block_interval = db.get_global_properties().parameters.block_interval;
+      const uint32_t transactions_per_block = transactions_per_second * block_interval;
+      const uint32_t block_count = 2 * expiration_window / block_interval;
+      const auto& dedupe_index = db.get_index_type<transaction_index>().indices();
+
+      uint64_t rss_before = resident_memory_kb();
+      fc::microseconds push_elapsed;
+      fc::microseconds generate_elapsed;
+      for( uint32_t b = 0; b < block_count; ++b )
+      {
+         auto start = fc::time_point::now();
+         for( uint32_t i = 0; i < transactions_per_block; ++i )
+         {
+            signed_transaction tx;
+            transfer_operation op;
+            op.from = alice_id;
+            op.to = bob_id;
+            op.amount = asset( 1 + i % 100 );
+            tx.operations.push_back( op );
+            tx.expiration = db.head_block_time() + fc::seconds( expiration_window - i / 100 );
+            db.push_transaction( tx, ~0 );
+         }
+         auto generated = fc::time_point::now();
+         generate_block();
+         push_elapsed += generated - start;
+         generate_elapsed += fc::time_point::now() - generated;
+      }
+
+      BOOST_CHECK( dedupe_index.size() <= (expiration_window / block_interval + 1) * transactions_per_block );
+      ilog( "${n} transactions at ${r} tx/s with a ${w} s expiration window: ${d} dedupe entries, ${m} KiB more resident memory",
+            ("n", uint64_t(block_count) * transactions_per_block)("r", transactions_per_second)("w", expiration_window)
+            ("d", dedupe_index.size())("m", resident_memory_kb() - rss_before) );
+      ilog( "Average per block of ${t} transactions: ${p} ms pushing them, ${g} ms producing the block",
+            ("t", transactions_per_block)("p", push_elapsed.count() / 1000 / block_count)
+            ("g", generate_elapsed.count() / 1000 / block_count) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( blind_transfer_block_benchmark, database_fixture )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t transfer_count = 500;
+#else
+      const uint32_t transfer_count = 50;
+#endif
+      ACTORS( (dan) );
+      fund( dan, asset(100000000) );
+      generate_block();
+
+      // one commitment per blind transfer, each spent into two outputs with range proofs
+      auto owner_key = fc::ecc::private_key::generate();
+      authority owner( 1, public_key_type( owner_key.get_public_key() ), 1 );
+      vector<blind_transfer_operation> transfers;
+      for( uint32_t i = 0; i < transfer_count; ++i )
+      {
+         auto in_blind = fc::sha256::hash( "in-" + fc::to_string(i) );
+         auto out_blind = fc::sha256::hash( "out-" + fc::to_string(i) );
+         auto change_blind = fc::ecc::blind_sum( {in_blind, out_blind}, 1 );
+         auto nonce = fc::sha256::hash( "nonce-" + fc::to_string(i) );
+
+         blind_output input;
+         input.owner = owner;
+         input.commitment = fc::ecc::blind( in_blind, 1000 );
+         transfer_to_blind_operation to_blind;
+         to_blind.amount = asset(1000);
+         to_blind.from = dan_id;
+         to_blind.blinding_factor = in_blind;
+         to_blind.outputs = {input};
+         signed_transaction tx;
+         tx.operations = {to_blind};
+         set_expiration( db, tx );
+         db.push_transaction( tx, ~0 );
+
+         blind_output out, change;
+         out.owner = owner;
+         out.commitment = fc::ecc::blind( out_blind, 400 );
+         out.range_proof = fc::ecc::range_proof_sign( 0, out.commitment, out_blind, nonce, 0, 0, 400 );
+         change.owner = owner;
+         change.commitment = fc::ecc::blind( change_blind, 600 );
+         change.range_proof = fc::ecc::range_proof_sign( 0, change.commitment, change_blind, nonce, 0, 0, 600 );
+
+         blind_transfer_operation blind_tr;
+         blind_tr.inputs.push_back( {input.commitment, owner} );
+         if( change.commitment < out.commitment )
+            blind_tr.outputs = {change, out};
+         else
+            blind_tr.outputs = {out, change};
+         transfers.push_back( blind_tr );
+      }
+      generate_block();
+
+      for( const blind_transfer_operation& blind_tr : transfers )
+      {
+         signed_transaction tx;
+         tx.operations = {blind_tr};
+         set_expiration( db, tx );
+         db.push_transaction( tx, ~0 );
+      }
+      signed_block b = generate_block();
+      BOOST_REQUIRE_EQUAL( b.transactions.size(), transfer_count );
+
+      // apply the block on fresh nodes, which haven't verified any of it yet
+      const uint32_t skip = database::skip_transaction_signatures | database::skip_authority_check;
+      auto apply_on_fresh_node = [&]( uint32_t threads ) {
+         fc::temp_directory data_dir2( graphene::utilities::temp_directory_path() );
+         database db2;
+         db2.open( data_dir2.path(), [this]{ return genesis_state; } );
+         for( uint32_t num = 1; num < b.block_num(); ++num )
+            PUSH_BLOCK( db2, *db.fetch_block_by_number( num ), skip );
+         db2.node_properties().confidential_verification_threads = threads;
+         auto start = fc::time_point::now();
+         PUSH_BLOCK( db2, b, skip );
+         auto elapsed = fc::time_point::now() - start;
+         BOOST_CHECK( db2.head_block_id() == b.id() );
+         db2.close();
+         return elapsed;
+      };
+      auto single_threaded = apply_on_fresh_node( 1 );
+      auto multi_threaded = apply_on_fresh_node( 0 );
+
+      ilog( "Applied a block of ${n} blind transfers in ${s} milliseconds on one thread, ${m} milliseconds on ${t} threads",
+            ("n", transfer_count)("s", single_threaded.count() / 1000)("m", multi_threaded.count() / 1000)
+            ("t", std::thread::hardware_concurrency()) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( expiration_housekeeping_benchmark, database_fixture )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t object_count = 1000000;
+#else
+      const uint32_t object_count = 10000;
+#endif
+      const uint32_t bitasset_count = 100;
+      const uint32_t block_count = 1000;
+
+      ACTORS( (alice)(bob) );
+      const asset_id_type test_id = create_user_issued_asset( "TESTUIA" ).id;
+      issue_uia( alice_id, asset( object_count, test_id ) );
+      for( uint32_t i = 0; i < bitasset_count; ++i )
+         create_bitasset( "BITASSET" + fc::to_string( i ) );
+      generate_block();
+
+      // resting orders and proposals which expire long after the measured blocks, created directly since
+      // only their number matters here
+      const time_point_sec expiration = db.head_block_time() + fc::days( 365 );
+      db.adjust_balance( alice_id, asset( -int64_t( object_count ), test_id ) );
+      transfer_operation proposed_transfer;
+      proposed_transfer.from = alice_id;
+      proposed_transfer.to = bob_id;
+      proposed_transfer.amount = asset( 1 );
+      for( uint32_t i = 0; i < object_count; ++i )
+      {
+         db.create<limit_order_object>( [&]( limit_order_object& o ) {
+            o.seller = alice_id;
+            o.for_sale = 1;
+            o.sell_price = asset( 1, test_id ) / asset( 1 + i % 1000 );
+            o.expiration = expiration + fc::seconds( i );
+         });
+         db.create<proposal_object>( [&]( proposal_object& p ) {
+            p.expiration_time = expiration + fc::seconds( i );
+            p.proposed_transaction.operations.push_back( proposed_transfer );
+            p.required_active_approvals.insert( alice_id );
+         });
+      }
+      generate_block();
+
+      auto start = fc::time_point::now();
+      for( uint32_t i = 0; i < block_count; ++i )
+         generate_block();
+      auto elapsed = fc::time_point::now() - start;
+
+      ilog( "${b} empty blocks with ${n} resting orders, ${n} proposals and ${m} bitassets in ${t} milliseconds, "
+            "${u} microseconds per block",
+            ("b", block_count)("n", object_count)("m", bitasset_count)("t", elapsed.count() / 1000)
+            ("u", elapsed.count() / block_count) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( proposal_approval_benchmark, database_fixture )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t proposal_count = 1000;
+#else
+      const uint32_t proposal_count = 50;
+#endif
+      const uint32_t member_count = 20;
+      const uint32_t threshold = 10;
+      const uint32_t updates_per_block = 1000;
+
+      generate_block();
+      db.modify( db.get_global_properties(), [&]( global_property_object& p ) {
+         p.parameters.maximum_authority_membership = member_count;
+      });
+
+      // the council's active authority is 10 of 20 members, each member's is 10 of 20 keys of its own
+      ACTORS( (council)(payee) );
+      fund( council, asset(100000000) );
+      authority council_authority;
+      council_authority.weight_threshold = threshold;
+      vector< vector<public_key_type> > member_keys( member_count );
+      for( uint32_t m = 0; m < member_count; ++m )
+      {
+         const account_id_type member_id = create_account( "member" + fc::to_string( m ) ).id;
+         council_authority.account_auths[member_id] = 1;
+
+         account_update_operation op;
+         op.account = member_id;
+         op.active = authority();
+         op.active->weight_threshold = threshold;
+         for( uint32_t k = 0; k < member_count; ++k )
+         {
+            member_keys[m].push_back( generate_private_key( "member" + fc::to_string( m ) + "-" + fc::to_string( k ) )
+                                         .get_public_key() );
+            op.active->key_auths[member_keys[m].back()] = 1;
+         }
+         trx.operations.push_back( op );
+      }
+      account_update_operation council_update;
+      council_update.account = council_id;
+      council_update.active = council_authority;
+      trx.operations.push_back( council_update );
+      set_expiration( db, trx );
+      PUSH_TX( db, trx, ~0 );
+      trx.clear();
+      generate_block();
+
+      vector<proposal_id_type> proposals;
+      for( uint32_t i = 0; i < proposal_count; ++i )
+      {
+         transfer_operation top;
+         top.from = council_id;
+         top.to = payee_id;
+         top.amount = asset( 1 + i );
+
+         proposal_create_operation pop;
+         pop.proposed_ops.emplace_back( top );
+         pop.fee_paying_account = payee_id;
+         pop.expiration_time = db.head_block_time() + fc::days(1);
+         trx.operations.push_back( pop );
+         set_expiration( db, trx );
+         proposals.push_back( PUSH_TX( db, trx, ~0 ).operation_results[0].get<object_id_type>() );
+         trx.clear();
+      }
+      generate_block();
+
+      // every key of the first 10 members approves every proposal on its own, the last one executes it
+      const proposal_authorization_cache& cache = db.get_proposal_authorizations();
+      const uint64_t performed = cache.verifications_performed();
+      const uint64_t avoided = cache.verifications_avoided();
+      uint32_t update_count = 0;
+      auto start = fc::time_point::now();
+      for( uint32_t m = 0; m < threshold; ++m )
+      {
+         for( uint32_t k = 0; k < threshold; ++k )
+         {
+            for( const proposal_id_type& pid : proposals )
+            {
+               proposal_update_operation uop;
+               uop.proposal = pid;
+               uop.fee_paying_account = payee_id;
+               uop.key_approvals_to_add.insert( member_keys[m][k] );
+               signed_transaction tx;
+               tx.operations.push_back( uop );
+               tx.expiration = db.head_block_time() + fc::seconds( 60 + update_count % 3000 );
+               db.push_transaction( tx, ~0 );
+               if( ++update_count % updates_per_block == 0 )
+                  generate_block();
+            }
+         }
+      }
+      generate_block();
+      auto elapsed = fc::time_point::now() - start;
+
+      for( const proposal_id_type& pid : proposals )
+         BOOST_CHECK( db.find( pid ) == nullptr );
+      ilog( "${n} approvals of ${p} proposals needing 10 of 20 members of 10 of 20 keys in ${t} milliseconds, "
+            "${r} approvals/s, ${v} full verifications, ${a} avoided",
+            ("n", update_count)("p", proposal_count)("t", elapsed.count() / 1000)
+            ("r", uint64_t(update_count) * 1000000 / std::max<int64_t>( elapsed.count(), 1 ))
+            ("v", cache.verifications_performed() - performed)("a", cache.verifications_avoided() - avoided) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( authority_check_benchmark, database_fixture )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t transaction_count = 100000;
+#else
+      const uint32_t transaction_count = 5000;
+#endif
+      const uint32_t gateway_count = 10;
+      const uint32_t member_count = 5;
+      const uint32_t threshold = 3;
+
+      // every gateway's active authority is 3 of 5 member accounts, each member's is a key of its own
+      ACTOR( payee );
+      vector< account_id_type > gateways;
+      vector< vector<public_key_type> > member_keys( gateway_count );
+      for( uint32_t g = 0; g < gateway_count; ++g )
+      {
+         authority gateway_authority;
+         gateway_authority.weight_threshold = threshold;
+         for( uint32_t m = 0; m < member_count; ++m )
+         {
+            const string name = "gateway" + fc::to_string( g ) + "-member" + fc::to_string( m );
+            member_keys[g].push_back( generate_private_key( name ).get_public_key() );
+            gateway_authority.account_auths[create_account( name, member_keys[g].back() ).id] = 1;
+         }
+         const account_object& gateway = create_account( "gateway" + fc::to_string( g ) );
+         db.modify( gateway, [&]( account_object& a ) {
+            a.active = gateway_authority;
+         });
+         gateways.push_back( gateway.id );
+      }
+      generate_block();
+
+      // a block of transfers out of the gateways, each signed by 3 of its members picked in turn
+      vector< signed_transaction > transactions( transaction_count );
+      vector< flat_set<public_key_type> > signers( transaction_count );
+      for( uint32_t i = 0; i < transaction_count; ++i )
+      {
+         const uint32_t g = i % gateway_count;
+         transfer_operation op;
+         op.from = gateways[g];
+         op.to = payee_id;
+         op.amount = asset( 1 + i );
+         transactions[i].operations.push_back( op );
+         for( uint32_t k = 0; k < threshold; ++k )
+            signers[i].insert( member_keys[g][(i / gateway_count + k) % member_count] );
+      }
+
+      authority_resolver& resolver = db.get_authority_resolver();
+      const uint32_t max_authority_depth = db.get_global_properties().parameters.max_authority_depth;
+      auto check_all = [&]( bool remember ) -> int64_t {
+         resolver.clear();
+         auto start = fc::time_point::now();
+         for( uint32_t i = 0; i < transaction_count; ++i )
+         {
+            if( !remember )
+               resolver.clear();
+            resolver.verify_authority( db, transactions[i], signers[i], max_authority_depth );
+         }
+         return std::max<int64_t>( (fc::time_point::now() - start).count(), 1 );
+      };
+
+      const int64_t walked = check_all( false );
+      const int64_t remembered = check_all( true );
+      ilog( "${n} authority checks of 3 of 5 multisig transfers, ${w} checks/s walking every authority tree, "
+            "${r} checks/s remembering verified authorities",
+            ("n", transaction_count)
+            ("w", uint64_t(transaction_count) * 1000000 / walked)
+            ("r", uint64_t(transaction_count) * 1000000 / remembered) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( block_serialization_benchmark, database_fixture )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t iterations = 1000;
+#else
+      const uint32_t iterations = 20;
+#endif
+      const uint32_t transaction_count = 2000;
+
+      // a block of signed transfers mixed with limit orders
+      ACTORS( (alice)(bob) );
+      fund( alice, asset(100000000) );
+      fund( bob, asset(100000000) );
+      const asset_id_type test_id = create_user_issued_asset( "TESTUIA" ).id;
+      generate_block();
+      for( uint32_t i = 0; i < transaction_count; ++i )
+      {
+         signed_transaction tx;
+         if( i % 4 == 3 )
+         {
+            limit_order_create_operation op;
+            op.seller = bob_id;
+            op.amount_to_sell = asset( 1000 + i );
+            op.min_to_receive = asset( 1000 + i, test_id );
+            op.expiration = db.head_block_time() + fc::days(1);
+            tx.operations.push_back( op );
+         }
+         else
+         {
+            transfer_operation op;
+            op.from = alice_id;
+            op.to = bob_id;
+            op.amount = asset( 1 + i );
+            tx.operations.push_back( op );
+         }
+         set_expiration( db, tx );
+         sign( tx, (i % 4 == 3) ? bob_private_key : alice_private_key );
+         PUSH_TX( db, tx, ~0 );
+      }
+      generate_block();
+
+      const signed_block block = *db.fetch_block_by_number( db.head_block_num() );
+      const chain_id_type& chain_id = db.get_chain_id();
+      const vector<char> packed = fc::raw::pack( block );
+      BOOST_CHECK( graphene::db::pack_to_buffer( block ) == packed );
+      size_t transaction_bytes = 0;
+      for( const processed_transaction& tx : block.transactions )
+      {
+         const vector<char>& packed_trx = graphene::db::pack_to_buffer( static_cast<const transaction&>( tx ) );
+         BOOST_CHECK( transaction::id_from_packed( packed_trx ) == tx.transaction::id() );
+         BOOST_CHECK( transaction::sig_digest_from_packed( chain_id, packed_trx ) == tx.sig_digest( chain_id ) );
+         transaction_bytes += packed_trx.size();
+      }
+
+      // bytes per microsecond are megabytes per second
+      auto measure = [&]( const string& what, size_t bytes, const std::function<void()>& f ) {
+         auto start = fc::time_point::now();
+         for( uint32_t i = 0; i < iterations; ++i )
+            f();
+         auto elapsed = fc::time_point::now() - start;
+         ilog( "${what}: ${r} MB/s", ("what", what)
+               ("r", uint64_t( bytes ) * iterations / std::max<int64_t>( elapsed.count(), 1 )) );
+      };
+      size_t sink = 0;
+      measure( "pack block into a new vector", packed.size(), [&]() {
+         sink += fc::raw::pack( block ).size();
+      });
+      measure( "pack block into the thread's buffer", packed.size(), [&]() {
+         sink += graphene::db::pack_to_buffer( block ).size();
+      });
+      measure( "size block", packed.size(), [&]() {
+         sink += fc::raw::pack_size( block );
+      });
+      measure( "unpack block", packed.size(), [&]() {
+         sink += fc::raw::unpack<signed_block>( packed ).transactions.size();
+      });
+      measure( "hash packed block", packed.size(), [&]() {
+         sink += digest_type::hash( packed.data(), packed.size() )._hash[0];
+      });
+      measure( "block merkle root", packed.size(), [&]() {
+         sink += block.calculate_merkle_root()._hash[0];
+      });
+      measure( "transaction ids and signature digests, packing twice", transaction_bytes, [&]() {
+         for( const processed_transaction& tx : block.transactions )
+            sink += tx.transaction::id()._hash[0] + tx.sig_digest( chain_id )._hash[0];
+      });
+      measure( "transaction ids and signature digests, packing once", transaction_bytes, [&]() {
+         for( const processed_transaction& tx : block.transactions )
+         {
+            const vector<char>& packed_trx = graphene::db::pack_to_buffer( static_cast<const transaction&>( tx ) );
+            sink += transaction::id_from_packed( packed_trx )._hash[0]
+                  + transaction::sig_digest_from_packed( chain_id, packed_trx )._hash[0];
+         }
+      });
+      ilog( "${n} transactions, ${b} bytes per block, ${s}", ("n", block.transactions.size())("b", packed.size())("s", sink) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( pending_transaction_flood_benchmark, database_fixture )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t transaction_count = 100000;
+#else
+      const uint32_t transaction_count = 10000;
+#endif
+      const uint32_t pool_limit = 10000;
+
+      ACTORS( (alice)(bob) );
+      fund( alice, asset(1000000000) );
+      generate_block();
+
+      db.node_properties().max_pending_transactions = pool_limit;
+
+      // every transaction declares a different fee, so some outbid the pool and some don't get in
+      uint32_t accepted = 0;
+      uint32_t rejected = 0;
+      auto start = fc::time_point::now();
+      for( uint32_t i = 0; i < transaction_count; ++i )
+      {
+         signed_transaction tx;
+         transfer_operation op;
+         op.from = alice_id;
+         op.to = bob_id;
+         op.fee = asset( 100 + (i * 7919) % 10007 );
+         op.amount = asset(1);
+         tx.operations.push_back( op );
+         tx.expiration = db.head_block_time() + fc::seconds( 60 + i % 3000 );
+         try
+         {
+            db.push_transaction( tx, ~0 );
+            ++accepted;
+         }
+         catch( const pending_transaction_pool_full& )
+         {
+            ++rejected;
+         }
+      }
+      auto push_elapsed = fc::time_point::now() - start;
+
+      start = fc::time_point::now();
+      signed_block b = generate_block();
+      auto generate_elapsed = fc::time_point::now() - start;
+
+      BOOST_CHECK( b.transactions.size() <= pool_limit );
+      ilog( "Pushed ${n} transactions in ${t} milliseconds (${r} tx/s): ${a} accepted, ${j} rejected by the pool",
+            ("n", transaction_count)("t", push_elapsed.count() / 1000)
+            ("r", uint64_t(transaction_count) * 1000000 / std::max<int64_t>( push_elapsed.count(), 1 ))
+            ("a", accepted)("j", rejected) );
+      ilog( "Generated a block of ${c} transactions from a pool limited to ${l} in ${t} milliseconds",
+            ("c", b.transactions.size())("l", pool_limit)("t", generate_elapsed.count() / 1000) );
+   } FC_LOG_AND_RETHROW()
+}
+
 /*
 BOOST_AUTO_TEST_CASE( transfer_benchmark )
 {
@@ -27,6 +27,7 @@
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/protocol/protocol.hpp>
 #include <graphene/chain/exceptions.hpp>
+#include <graphene/chain/hardfork.hpp>
 
 #include <graphene/chain/account_object.hpp>
 #include <graphene/chain/asset_object.hpp>
@@ -882,6 +883,208 @@ BOOST_FIXTURE_TEST_CASE( proposal_owner_authority_complete, database_fixture )
    }
 } FC_LOG_AND_RETHROW() }
 
+BOOST_FIXTURE_TEST_CASE( proposal_authorization_cache_test, database_fixture )
+{ try {
+   generate_block();
+
+   ACTORS( (alice)(bob)(carol)(multisig) );
+   fund( multisig, asset(100000) );
+   const public_key_type dave_key = generate_private_key( "dave" ).get_public_key();
+
+   db.modify( multisig, [&]( account_object& a ) {
+      a.active = authority( 2, alice_id, 1, bob_id, 1 );
+   });
+
+   transfer_operation top;
+   top.from = multisig_id;
+   top.to = carol_id;
+   top.amount = asset(500);
+
+   proposal_create_operation pop;
+   pop.proposed_ops.emplace_back( top );
+   pop.fee_paying_account = carol_id;
+   pop.expiration_time = db.head_block_time() + fc::days(1);
+   trx.operations.push_back( pop );
+   set_expiration( db, trx );
+   const proposal_id_type pid = PUSH_TX( db, trx, ~0 ).operation_results[0].get<object_id_type>();
+   trx.clear();
+
+   auto approve = [&]( const flat_set<account_id_type>& accounts, const flat_set<public_key_type>& keys ) {
+      proposal_update_operation uop;
+      uop.proposal = pid;
+      uop.fee_paying_account = carol_id;
+      uop.active_approvals_to_add = accounts;
+      uop.key_approvals_to_add = keys;
+      trx.operations.push_back( uop );
+      set_expiration( db, trx );
+      PUSH_TX( db, trx, ~0 );
+      trx.clear();
+   };
+   const proposal_authorization_cache& cache = db.get_proposal_authorizations();
+
+   // neither a key nobody's authority names nor alice alone get the full verification to run
+   const uint64_t performed = cache.verifications_performed();
+   const uint64_t avoided = cache.verifications_avoided();
+   approve( {}, { dave_key } );
+   approve( { alice_id }, {} );
+   BOOST_CHECK( db.find( pid ) != nullptr );
+   BOOST_CHECK_EQUAL( cache.verifications_performed(), performed );
+   BOOST_CHECK_EQUAL( cache.verifications_avoided(), avoided + 2 );
+
+   // bob handing his active authority to the key which already approved counts at once
+   db.modify( bob, [&]( account_object& a ) {
+      a.active = authority( 1, dave_key, 1 );
+   });
+   BOOST_CHECK( pid(db).is_authorized_to_execute( db ) );
+   BOOST_CHECK_EQUAL( cache.verifications_performed(), performed + 1 );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_FIXTURE_TEST_CASE( proposal_authorization_cache_temp_account, database_fixture )
+{ try {
+   generate_block();
+
+   ACTORS( (alice)(bob)(carol)(multisig) );
+   fund( multisig, asset(100000) );
+   const public_key_type dave_key = generate_private_key( "dave" ).get_public_key();
+   BOOST_REQUIRE( db.get_global_properties().parameters.max_authority_depth == 2 );
+
+   // the temp account is only named by bob, at the deepest level verify_authority() looks at
+   db.modify( multisig, [&]( account_object& a ) {
+      a.active = authority( 1, alice_id, 1 );
+   });
+   db.modify( alice, [&]( account_object& a ) {
+      a.active = authority( 1, bob_id, 1 );
+   });
+   db.modify( bob, [&]( account_object& a ) {
+      a.active = authority( 1, GRAPHENE_TEMP_ACCOUNT, 1 );
+   });
+
+   transfer_operation top;
+   top.from = multisig_id;
+   top.to = carol_id;
+   top.amount = asset(500);
+
+   proposal_create_operation pop;
+   pop.proposed_ops.emplace_back( top );
+   pop.fee_paying_account = carol_id;
+   pop.expiration_time = db.head_block_time() + fc::days(1);
+   trx.operations.push_back( pop );
+   set_expiration( db, trx );
+   const proposal_id_type pid = PUSH_TX( db, trx, ~0 ).operation_results[0].get<object_id_type>();
+   trx.clear();
+
+   BOOST_CHECK( pid(db).is_authorized_to_execute( db ) );
+
+   // any update lets it execute
+   proposal_update_operation uop;
+   uop.proposal = pid;
+   uop.fee_paying_account = carol_id;
+   uop.key_approvals_to_add.insert( dave_key );
+   trx.operations.push_back( uop );
+   set_expiration( db, trx );
+   PUSH_TX( db, trx, ~0 );
+   trx.clear();
+   BOOST_CHECK( db.find( pid ) == nullptr );
+   BOOST_CHECK_EQUAL( get_balance( carol_id, asset_id_type() ), 500 );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_FIXTURE_TEST_CASE( proposal_authorization_cache_unmatched_address, database_fixture )
+{ try {
+   generate_block();
+
+   ACTORS( (alice)(carol)(multisig) );
+   fund( multisig, asset(100000) );
+   const public_key_type dave_key = generate_private_key( "dave" ).get_public_key();
+
+   // no key approving the proposals matches the address
+   db.modify( multisig, [&]( account_object& a ) {
+      a.active = authority( 1, address( generate_private_key( "nobody" ).get_public_key() ), 1 );
+   });
+
+   auto propose = [&]() -> proposal_id_type {
+      transfer_operation top;
+      top.from = multisig_id;
+      top.to = carol_id;
+      top.amount = asset(500);
+
+      proposal_create_operation pop;
+      pop.proposed_ops.emplace_back( top );
+      pop.fee_paying_account = carol_id;
+      pop.expiration_time = db.head_block_time() + fc::days(1);
+      trx.operations.push_back( pop );
+      set_expiration( db, trx );
+      const proposal_id_type pid = PUSH_TX( db, trx, ~0 ).operation_results[0].get<object_id_type>();
+      trx.clear();
+      return pid;
+   };
+   auto approve = [&]( proposal_id_type pid ) {
+      proposal_update_operation uop;
+      uop.proposal = pid;
+      uop.fee_paying_account = carol_id;
+      uop.key_approvals_to_add.insert( dave_key );
+      trx.operations.push_back( uop );
+      set_expiration( db, trx );
+      PUSH_TX( db, trx, ~0 );
+      trx.clear();
+   };
+   const proposal_authorization_cache& cache = db.get_proposal_authorizations();
+
+   // before the hardfork the unmatched address counts as signed, so the full verification must run
+   BOOST_REQUIRE( db.head_block_time() < HARDFORK_ADDRESS_AUTH_TIME );
+   const proposal_id_type before = propose();
+   approve( before );
+   BOOST_CHECK( db.find( before ) == nullptr );
+   BOOST_CHECK_EQUAL( get_balance( carol_id, asset_id_type() ), 500 );
+
+   generate_blocks( HARDFORK_ADDRESS_AUTH_TIME );
+   generate_block();
+   const proposal_id_type after = propose();
+   const uint64_t avoided = cache.verifications_avoided();
+   approve( after );
+   BOOST_CHECK( db.find( after ) != nullptr );
+   BOOST_CHECK_EQUAL( cache.verifications_avoided(), avoided + 1 );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_FIXTURE_TEST_CASE( authority_resolver_test, database_fixture )
+{ try {
+   ACTORS( (alice)(bob) );
+   fund( alice, asset(100000) );
+   const fc::ecc::private_key new_key = generate_private_key( "alice new" );
+
+   auto transfer_from_alice = [&]( const fc::ecc::private_key& key, int64_t amount ) {
+      transfer_operation op;
+      op.from = alice_id;
+      op.to = bob_id;
+      op.amount = asset(amount);
+      signed_transaction tx;
+      tx.operations.push_back( op );
+      set_expiration( db, tx );
+      sign( tx, key );
+      PUSH_TX( db, tx );
+   };
+   const authority_resolver& resolver = db.get_authority_resolver();
+
+   // the second transfer signed by the same key is not walked again
+   const uint64_t performed = resolver.checks_performed();
+   const uint64_t avoided = resolver.checks_avoided();
+   transfer_from_alice( alice_private_key, 1 );
+   transfer_from_alice( alice_private_key, 2 );
+   BOOST_CHECK_EQUAL( resolver.checks_performed(), performed + 1 );
+   BOOST_CHECK_EQUAL( resolver.checks_avoided(), avoided + 1 );
+
+   // once alice replaced her keys, what passed with the old one is forgotten
+   db.modify( alice, [&]( account_object& a ) {
+      a.owner = authority( 1, public_key_type( new_key.get_public_key() ), 1 );
+      a.active = a.owner;
+   });
+   GRAPHENE_REQUIRE_THROW( transfer_from_alice( alice_private_key, 3 ), fc::exception );
+   transfer_from_alice( new_key, 3 );
+   transfer_from_alice( new_key, 4 );
+   BOOST_CHECK_EQUAL( resolver.checks_performed(), performed + 3 );
+   BOOST_CHECK_EQUAL( resolver.checks_avoided(), avoided + 2 );
+   BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 10 );
+} FC_LOG_AND_RETHROW() }
+
 BOOST_FIXTURE_TEST_CASE( max_authority_membership, database_fixture )
 {
    try
@@ -1313,4 +1516,46 @@ BOOST_FIXTURE_TEST_CASE( nonminimal_sig_test, database_fixture )
    }
 }
 
+BOOST_FIXTURE_TEST_CASE( unmatched_address_auth, database_fixture )
+{
+   try
+   {
+      ACTORS( (alice)(bob) );
+
+      authority address_auth( 1, address( generate_private_key( "nobody" ).get_public_key() ), 1 );
+      auto get_active = [&]( account_id_type aid ) -> const authority*
+      {
+         return aid == alice_id ? &address_auth : &(aid(db).active);
+      };
+      auto get_owner = [&]( account_id_type aid ) -> const authority*
+      {
+         return aid == alice_id ? &address_auth : &(aid(db).owner);
+      };
+
+      transfer_operation op;
+      op.from = alice_id;
+      op.to = bob_id;
+      op.amount = asset(1);
+      vector<operation> ops{ op };
+
+      // Before HARDFORK_ADDRESS_AUTH_TIME an address matching none of the keys counts as signed
+      graphene::chain::verify_authority( ops, flat_set<public_key_type>(), get_active, get_owner, 2,
+                                         false, flat_set<account_id_type>(), flat_set<account_id_type>(), true );
+      GRAPHENE_REQUIRE_THROW( graphene::chain::verify_authority( ops, flat_set<public_key_type>(), get_active, get_owner, 2,
+                                                                 false, flat_set<account_id_type>(),
+                                                                 flat_set<account_id_type>(), false ),
+                              fc::exception );
+
+      // A matching key satisfies the address either way
+      flat_set<public_key_type> keys{ generate_private_key( "nobody" ).get_public_key() };
+      graphene::chain::verify_authority( ops, keys, get_active, get_owner, 2,
+                                         false, flat_set<account_id_type>(), flat_set<account_id_type>(), false );
+   }
+   catch(fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -32,6 +32,8 @@
 #include <graphene/chain/committee_member_object.hpp>
 #include <graphene/chain/proposal_object.hpp>
 #include <graphene/chain/market_object.hpp>
+#include <graphene/chain/transaction_object.hpp>
+#include <graphene/chain/witness_object.hpp>
 #include <graphene/chain/witness_schedule_object.hpp>
 
 #include <graphene/utilities/tempdir.hpp>
@@ -118,7 +120,11 @@ BOOST_AUTO_TEST_CASE( block_database_test )
          auto blk = bdb.fetch_by_number( i+1 );
          FC_ASSERT( blk.valid() );
          FC_ASSERT( blk->witness == witness_id_type(blk->block_num()) );
+         auto packed = bdb.fetch_packed_by_number( i+1 );
+         FC_ASSERT( packed.valid() );
+         FC_ASSERT( *packed == fc::raw::pack( *blk ) );
       }
+      FC_ASSERT( !bdb.fetch_packed_by_number( 6 ).valid() );
 
    } catch (fc::exception& e) {
       edump((e.to_detail_string()));
@@ -714,6 +720,358 @@ BOOST_FIXTURE_TEST_CASE( maintenance_interval, database_fixture )
 }
 
 
+BOOST_FIXTURE_TEST_CASE( parallel_vote_tally, database_fixture )
+{
+   try {
+      // "voter3-referrer" sorts in between the voters, so it receives cashback in the middle of the name order pass
+      ACTOR( registrar );
+      const account_object& voter3_referrer = create_account( "voter3-referrer" );
+      const account_id_type voter3_referrer_id = voter3_referrer.id;
+      for( const account_object* a : { &registrar, &voter3_referrer } )
+      {
+         upgrade_to_lifetime_member( *a );
+         fund( *a, asset(10000000) );
+      }
+      vector<vote_id_type> witness_votes;
+      for( uint32_t w = 1; w <= 5; ++w )
+         witness_votes.push_back( witness_id_type(w)(db).vote_id );
+
+      auto vote_for = [&]( const account_object& account, vote_id_type vote ) {
+         account_update_operation op;
+         op.account = account.id;
+         op.new_options = account.options;
+         op.new_options->votes.insert( vote );
+         trx.operations.push_back( op );
+         PUSH_TX( db, trx, ~0 );
+         trx.operations.clear();
+      };
+
+      // voters registered by registrar and every other one referred by voter3-referrer
+      vector<account_id_type> voters;
+      for( uint32_t i = 0; i < 60; ++i )
+      {
+         const account_object& voter = create_account( "voter" + fc::to_string(i), registrar,
+                                                       i % 2 ? voter3_referrer : registrar, 50 );
+         voters.push_back( voter.id );
+         fund( voter, asset(100000 + i * 1000) );
+         vote_for( voter, witness_votes[i % witness_votes.size()] );
+      }
+      vote_for( registrar_id(db), witness_votes[0] );
+      vote_for( voter3_referrer_id(db), witness_votes[1] );
+
+      enable_fees();
+      for( size_t i = 0; i < voters.size(); ++i )
+         transfer( voters[i], registrar_id, asset(1000) );
+      generate_block();
+
+      auto cashback = [&]( account_id_type id ) -> share_type {
+         const account_object& a = id(db);
+         return a.cashback_vb.valid() ? (*a.cashback_vb)(db).balance.amount : share_type();
+      };
+      const share_type referrer_cashback = cashback( voter3_referrer_id );
+
+      generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+      signed_block maintenance_block = *db.fetch_block_by_number( db.head_block_num() );
+      BOOST_CHECK_GT( cashback( voter3_referrer_id ).value, referrer_cashback.value );
+
+      // the maintenance block tallies what the old interleaved tally counts, with any number of threads
+      db.pop_block();
+      const vector<uint64_t> reference = name_order_vote_tally();
+      for( uint32_t threads : { 1, 4 } )
+      {
+         if( db.head_block_num() == maintenance_block.block_num() )
+            db.pop_block();
+         db.node_properties().maintenance_threads = threads;
+         PUSH_BLOCK( db, maintenance_block, ~0 );
+         for( const witness_object& wit : db.get_index_type<witness_index>().indices() )
+            BOOST_CHECK_EQUAL( wit.total_votes, reference[wit.vote_id.instance()] );
+      }
+      BOOST_CHECK_GT( witness_id_type(2)(db).total_votes, 0u );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( incremental_vote_tally, database_fixture )
+{
+   try {
+      ACTOR( registrar );
+      upgrade_to_lifetime_member( registrar );
+      fund( registrar, asset(10000000) );
+      const committee_member_id_type committee_member_id = create_committee_member( registrar ).id;
+      const vote_id_type committee_vote = committee_member_id(db).vote_id;
+      const vote_id_type witness_vote = witness_id_type(1)(db).vote_id;
+      const asset_id_type test_asset = create_user_issued_asset( "TESTASSET" ).id;
+
+      auto update_options = [&]( account_id_type account, std::function<void(account_options&)> f ) {
+         account_update_operation op;
+         op.account = account;
+         op.new_options = account(db).options;
+         f( *op.new_options );
+         trx.operations.push_back( op );
+         PUSH_TX( db, trx, ~0 );
+         trx.operations.clear();
+      };
+
+      // every third voter proxies to the registrar, the others vote themselves
+      vector<account_id_type> voters;
+      for( uint32_t i = 0; i < 30; ++i )
+      {
+         const account_object& voter = create_account( "voter" + fc::to_string(i), registrar, registrar, 50 );
+         voters.push_back( voter.id );
+         fund( voter, asset(100000 + i * 1000) );
+         update_options( voter.id, [&]( account_options& o ) {
+            if( i % 3 == 0 )
+               o.voting_account = registrar_id;
+            else
+               o.votes.insert( i % 2 ? committee_vote : witness_vote );
+         });
+      }
+      update_options( registrar_id, [&]( account_options& o ) { o.votes.insert( committee_vote ); } );
+
+      // the first maintenance interval counts all accounts, later ones only apply what changed
+      db.node_properties().incremental_vote_tally = true;
+      generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+
+      enable_fees();
+      for( size_t i = 0; i < voters.size(); i += 4 )
+         transfer( voters[i], registrar_id, asset(1000) );
+      create_sell_order( voters[1], asset(5000), asset(5000, test_asset) );
+      update_options( voters[2], [&]( account_options& o ) { o.votes.erase( witness_vote ); o.votes.insert( committee_vote ); } );
+      update_options( voters[3], [&]( account_options& o ) { o.voting_account = registrar_id; } );
+      update_options( voters[6], [&]( account_options& o ) { o.voting_account = GRAPHENE_PROXY_TO_SELF_ACCOUNT; } );
+      generate_block();
+
+      // changes that are undone must be taken back out of the tallies
+      update_options( registrar_id, [&]( account_options& o ) { o.votes.insert( witness_vote ); } );
+      transfer( registrar_id, voters[5], asset(500000) );
+      generate_block();
+      db.pop_block();
+      db.clear_pending();
+
+      auto record_tally = [&]() {
+         vector<uint64_t> result;
+         for( const witness_object& wit : db.get_index_type<witness_index>().indices() )
+            result.push_back( wit.total_votes );
+         for( const committee_member_object& cm : db.get_index_type<committee_member_index>().indices() )
+            result.push_back( cm.total_votes );
+         return result;
+      };
+
+      generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+      const vector<uint64_t> incremental = record_tally();
+      BOOST_CHECK_GT( committee_member_id(db).total_votes, 0u );
+
+      // apply the same maintenance block again with a full recount
+      signed_block maintenance_block = *db.fetch_block_by_number( db.head_block_num() );
+      db.pop_block();
+      db.node_properties().incremental_vote_tally = false;
+      PUSH_BLOCK( db, maintenance_block, ~0 );
+      BOOST_CHECK( record_tally() == incremental );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( produce_from_pending_state, database_fixture )
+{
+   try {
+      ACTORS( (alice)(bob) );
+      fund( alice, asset(1000000) );
+      generate_block();
+
+      // a second node applies every block in full; the test transactions are not signed
+      const uint32_t skip = database::skip_transaction_signatures | database::skip_authority_check;
+      fc::temp_directory data_dir2( graphene::utilities::temp_directory_path() );
+      database db2;
+      db2.open( data_dir2.path(), [this]{ return genesis_state; } );
+      for( uint32_t num = 1; num <= db.head_block_num(); ++num )
+         PUSH_BLOCK( db2, *db.fetch_block_by_number( num ), skip );
+
+      vector<operation_history_object> produced_ops;
+      vector<operation_history_object> applied_ops;
+      auto record_ops = []( database& d, vector<operation_history_object>& ops ) {
+         return d.applied_block.connect( [&d,&ops]( const signed_block& ) {
+            for( const optional<operation_history_object>& o : d.get_applied_operations() )
+               if( o.valid() )
+                  ops.push_back( *o );
+         });
+      };
+      boost::signals2::scoped_connection produced_connection = record_ops( db, produced_ops );
+      boost::signals2::scoped_connection applied_connection = record_ops( db2, applied_ops );
+
+      db.node_properties().produce_from_pending_state = true;
+      const uint64_t from_pending_state = db.blocks_produced_from_pending_state();
+      const uint64_t by_reapplying = db.blocks_produced_by_reapplying();
+      for( uint32_t i = 0; i < 5; ++i )
+      {
+         transfer( alice_id, bob_id, asset(100 + i) );
+         transfer( bob_id, alice_id, asset(10) );
+         signed_block b = generate_block();
+         BOOST_CHECK_EQUAL( b.transactions.size(), 2u );
+         PUSH_BLOCK( db2, b, skip );
+      }
+      BOOST_CHECK_EQUAL( db.blocks_produced_from_pending_state(), from_pending_state + 5 );
+      BOOST_CHECK_EQUAL( db.blocks_produced_by_reapplying(), by_reapplying );
+
+      // transactions pushed skipping a check the block doesn't skip have to be applied again
+      transfer( alice_id, bob_id, asset(200) );
+      signed_block b = generate_block( ~0 & ~database::skip_transaction_dupe_check );
+      BOOST_CHECK_EQUAL( b.transactions.size(), 1u );
+      PUSH_BLOCK( db2, b, skip );
+      BOOST_CHECK_EQUAL( db.blocks_produced_from_pending_state(), from_pending_state + 5 );
+      BOOST_CHECK_EQUAL( db.blocks_produced_by_reapplying(), by_reapplying + 1 );
+
+      BOOST_CHECK( db2.head_block_id() == db.head_block_id() );
+      BOOST_CHECK_EQUAL( db.get_balance( alice_id, asset_id_type() ).amount.value,
+                         db2.get_balance( alice_id, asset_id_type() ).amount.value );
+      BOOST_CHECK_EQUAL( db.get_balance( bob_id, asset_id_type() ).amount.value,
+                         db2.get_balance( bob_id, asset_id_type() ).amount.value );
+
+      // the operation history of a block produced from the pending state matches a full application
+      BOOST_REQUIRE_EQUAL( produced_ops.size(), applied_ops.size() );
+      for( size_t i = 0; i < produced_ops.size(); ++i )
+      {
+         BOOST_CHECK_EQUAL( produced_ops[i].op.which(), applied_ops[i].op.which() );
+         BOOST_CHECK_EQUAL( produced_ops[i].block_num, applied_ops[i].block_num );
+         BOOST_CHECK_EQUAL( produced_ops[i].trx_in_block, applied_ops[i].trx_in_block );
+         BOOST_CHECK_EQUAL( produced_ops[i].op_in_trx, applied_ops[i].op_in_trx );
+      }
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( pending_transaction_pool_limits, database_fixture )
+{
+   try {
+      ACTORS( (alice)(bob) );
+      fund( alice, asset(1000000) );
+      generate_block();
+
+      auto make_transfer = [&]( share_type fee, share_type amount ) {
+         signed_transaction tx;
+         transfer_operation op;
+         op.from = alice_id;
+         op.to = bob_id;
+         op.fee = asset(fee);
+         op.amount = asset(amount);
+         tx.operations.push_back( op );
+         set_expiration( db, tx );
+         return tx;
+      };
+
+      db.node_properties().max_pending_transactions = 2;
+      const signed_transaction evicted = make_transfer( 1000, 1 );
+      PUSH_TX( db, evicted, ~0 );
+      PUSH_TX( db, make_transfer( 2000, 2 ), ~0 );
+
+      // the pool is full and this one doesn't outbid anything
+      GRAPHENE_REQUIRE_THROW( PUSH_TX( db, make_transfer( 500, 3 ), ~0 ), pending_transaction_pool_full );
+
+      // a higher fee rate evicts the cheapest pending transaction, whose effects are taken out of the pending state
+      PUSH_TX( db, make_transfer( 3000, 4 ), ~0 );
+      GRAPHENE_REQUIRE_THROW( db.get_recent_transaction( evicted.id() ), fc::key_not_found_exception );
+      BOOST_CHECK( !db.is_known_transaction( evicted.id() ) );
+      BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 6 );
+      BOOST_CHECK_EQUAL( get_balance( alice_id, asset_id_type() ), 1000000 - 6 - 5000 );
+
+      signed_block b = generate_block();
+      BOOST_REQUIRE_EQUAL( b.transactions.size(), 2u );
+      BOOST_CHECK_EQUAL( b.transactions[0].operations[0].get<transfer_operation>().amount.amount.value, 2 );
+      BOOST_CHECK_EQUAL( b.transactions[1].operations[0].get<transfer_operation>().amount.amount.value, 4 );
+      BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 6 );
+
+      // a transaction larger than max_pending_transaction_bytes is rejected even by an empty pool
+      db.node_properties().max_pending_transaction_bytes = 1;
+      GRAPHENE_REQUIRE_THROW( PUSH_TX( db, make_transfer( 1000, 5 ), ~0 ), pending_transaction_pool_full );
+
+      // the block emptied the pool, so two transactions at the lowest fee rate fit again
+      db.node_properties().max_pending_transaction_bytes = 0;
+      PUSH_TX( db, make_transfer( 1000, 5 ), ~0 );
+      PUSH_TX( db, make_transfer( 1000, 6 ), ~0 );
+      BOOST_CHECK_EQUAL( generate_block().transactions.size(), 2u );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( stateless_validation_once_per_transaction, database_fixture )
+{
+   try {
+      ACTORS( (alice)(bob) );
+      fund( alice, asset(1000000) );
+      generate_block();
+
+      const validated_transaction_cache& cache = db.get_validated_transactions();
+      uint64_t performed = cache.validations_performed();
+      uint64_t avoided = cache.validations_avoided();
+
+      // pushed, re-applied when generating the block and applied again in the block: validated once
+      transfer( alice_id, bob_id, asset(100) );
+      BOOST_CHECK_EQUAL( cache.validations_performed(), performed + 1 );
+      generate_block();
+      BOOST_CHECK_EQUAL( cache.validations_performed(), performed + 1 );
+      BOOST_CHECK_EQUAL( cache.validations_avoided(), avoided + 2 );
+
+      // a transaction failing validation isn't remembered
+      signed_transaction tx;
+      transfer_operation op;
+      op.from = alice_id;
+      op.to = bob_id;
+      op.amount = asset(-1);
+      tx.operations.push_back( op );
+      set_expiration( db, tx );
+      size_t cached = cache.size();
+      GRAPHENE_REQUIRE_THROW( PUSH_TX( db, tx, ~0 ), fc::exception );
+      GRAPHENE_REQUIRE_THROW( PUSH_TX( db, tx, ~0 ), fc::exception );
+      BOOST_CHECK_EQUAL( cache.size(), cached );
+
+      // entries go away with the transactions they were recorded for
+      generate_blocks( db.head_block_time() + db.get_global_properties().parameters.maximum_time_until_expiration );
+      BOOST_CHECK_EQUAL( cache.size(), 0u );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( get_recent_transaction_from_block, database_fixture )
+{
+   try {
+      ACTORS( (alice)(bob) );
+      fund( alice, asset(1000000) );
+      generate_block();
+
+      auto make_transfer = [&]( share_type amount ) {
+         signed_transaction tx;
+         transfer_operation op;
+         op.from = alice_id;
+         op.to = bob_id;
+         op.amount = asset(amount);
+         tx.operations.push_back( op );
+         set_expiration( db, tx );
+         return tx;
+      };
+
+      for( bool from_pending_state : { false, true } )
+      {
+         db.node_properties().produce_from_pending_state = from_pending_state;
+         signed_transaction first = make_transfer( 1 );
+         signed_transaction second = make_transfer( 2 );
+         PUSH_TX( db, first, ~0 );
+         PUSH_TX( db, second, ~0 );
+
+         // still pending
+         BOOST_CHECK( db.get_recent_transaction( second.id() ).id() == second.id() );
+
+         signed_block b = generate_block();
+         BOOST_REQUIRE_EQUAL( b.transactions.size(), 2u );
+         const auto& dedupe_index = db.get_index_type<transaction_index>().indices().get<by_trx_id>();
+         auto itr = dedupe_index.find( second.id() );
+         BOOST_REQUIRE( itr != dedupe_index.end() );
+         BOOST_CHECK_EQUAL( itr->block_num, b.block_num() );
+         BOOST_CHECK_EQUAL( itr->trx_in_block, 1 );
+         BOOST_CHECK( itr->expiration == second.expiration );
+
+         signed_transaction recent = db.get_recent_transaction( second.id() );
+         BOOST_CHECK( recent.id() == second.id() );
+         BOOST_CHECK_EQUAL( recent.operations[0].get<transfer_operation>().amount.amount.value, 2 );
+         BOOST_CHECK( db.get_recent_transaction( first.id() ).id() == first.id() );
+      }
+      GRAPHENE_REQUIRE_THROW( db.get_recent_transaction( make_transfer( 3 ).id() ), fc::exception );
+   } FC_LOG_AND_RETHROW()
+}
+
 BOOST_FIXTURE_TEST_CASE( limit_order_expiration, database_fixture )
 { try {
    //Get a sane head block time
@@ -1301,4 +1659,36 @@ BOOST_FIXTURE_TEST_CASE( miss_many_blocks, database_fixture )
    }
 }
 
+
+BOOST_FIXTURE_TEST_CASE( evaluation_object_cache, database_fixture )
+{
+   try
+   {
+      ACTORS( (alice)(bob) );
+      fund( alice, asset(1000000) );
+      generate_block();
+
+      signed_transaction tx;
+      transfer_operation op;
+      op.from = alice_id;
+      op.to = bob_id;
+      op.fee = asset(1);
+      op.amount = asset(100);
+      tx.operations.push_back( op );
+      op.amount = asset(200);
+      tx.operations.push_back( op );
+      set_expiration( db, tx );
+
+      const evaluation_cache_stats before = db.get_evaluation_cache_stats();
+      PUSH_TX( db, tx, ~0 );
+      const evaluation_cache_stats& after = db.get_evaluation_cache_stats();
+
+      // the first transfer resolves the payer, its statistics, the core asset and its dynamic data, the
+      // recipient and the global properties; the second one finds all of them in the cache
+      BOOST_CHECK_EQUAL( after.lookups - before.lookups, 16u );
+      BOOST_CHECK_EQUAL( after.hits - before.hits, 10u );
+      BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 300 );
+   }
+   FC_LOG_AND_RETHROW()
+}
 BOOST_AUTO_TEST_SUITE_END()
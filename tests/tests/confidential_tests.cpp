@@ -35,6 +35,8 @@
 
 #include <graphene/db/simple_index.hpp>
 
+#include <graphene/utilities/tempdir.hpp>
+
 #include <fc/crypto/digest.hpp>
 #include "../common/database_fixture.hpp"
 
@@ -131,5 +133,65 @@ BOOST_AUTO_TEST_CASE( confidential_test )
 } FC_LOG_AND_RETHROW() }
 
 
+BOOST_AUTO_TEST_CASE( confidential_block_verification_test )
+{ try {
+   ACTORS( (dan) )
+   const asset_object& core = asset_id_type()(db);
+   transfer(account_id_type()(db), dan, core.amount(1000000));
+   generate_block();
+
+   // a second node applies the block in full
+   const uint32_t skip = database::skip_transaction_signatures | database::skip_authority_check;
+   fc::temp_directory data_dir2( graphene::utilities::temp_directory_path() );
+   database db2;
+   db2.open( data_dir2.path(), [this]{ return genesis_state; } );
+   for( uint32_t num = 1; num <= db.head_block_num(); ++num )
+      PUSH_BLOCK( db2, *db.fetch_block_by_number( num ), skip );
+   db2.node_properties().confidential_verification_threads = 3;
+
+   const uint32_t transaction_count = 5;
+   auto owner_key = fc::ecc::private_key::generate();
+   for( uint32_t i = 0; i < transaction_count; ++i )
+   {
+      auto blind1 = fc::sha256::hash( "blind1-" + fc::to_string(i) );
+      auto blind2 = fc::sha256::hash( "blind2-" + fc::to_string(i) );
+      auto nonce = fc::sha256::hash( "nonce-" + fc::to_string(i) );
+      blind_output out1, out2;
+      out1.owner = authority( 1, public_key_type( owner_key.get_public_key() ), 1 );
+      out2.owner = out1.owner;
+      out1.commitment = fc::ecc::blind( blind1, 100 + i );
+      out1.range_proof = fc::ecc::range_proof_sign( 0, out1.commitment, blind1, nonce, 0, 0, 100 + i );
+      out2.commitment = fc::ecc::blind( blind2, 200 );
+      out2.range_proof = fc::ecc::range_proof_sign( 0, out2.commitment, blind2, nonce, 0, 0, 200 );
+
+      transfer_to_blind_operation to_blind;
+      to_blind.amount = core.amount( 300 + i );
+      to_blind.from = dan.id;
+      to_blind.blinding_factor = fc::ecc::blind_sum( {blind1, blind2}, 2 );
+      if( out2.commitment < out1.commitment )
+         to_blind.outputs = {out2, out1};
+      else
+         to_blind.outputs = {out1, out2};
+
+      signed_transaction tx;
+      tx.operations = {to_blind};
+      set_expiration( db, tx );
+      PUSH_TX( db, tx, ~0 );
+   }
+   signed_block b = generate_block();
+   BOOST_REQUIRE_EQUAL( b.transactions.size(), transaction_count );
+
+   // verified on the workers, then found already verified while applying
+   const validated_transaction_cache& cache = db2.get_validated_transactions();
+   uint64_t performed = cache.validations_performed();
+   uint64_t avoided = cache.validations_avoided();
+   PUSH_BLOCK( db2, b, skip );
+   BOOST_CHECK_EQUAL( cache.validations_performed(), performed + transaction_count );
+   BOOST_CHECK_EQUAL( cache.validations_avoided(), avoided + transaction_count );
+   BOOST_CHECK( db2.head_block_id() == db.head_block_id() );
+   BOOST_CHECK_EQUAL( db2.get_balance( dan_id, asset_id_type() ).amount.value, get_balance( dan_id, asset_id_type() ) );
+} FC_LOG_AND_RETHROW() }
+
+
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -59,3 +59,85 @@ BOOST_AUTO_TEST_CASE( undo_test )
       throw;
    }
 }
+
+BOOST_AUTO_TEST_CASE( dense_index_find_test )
+{
+   try {
+      database db;
+      vector<account_balance_id_type> ids;
+      {
+         auto ses = db._undo_db.start_undo_session();
+         for( uint32_t i = 0; i < 10000; ++i )
+            ids.push_back( db.create<account_balance_object>( [&]( account_balance_object& obj ){
+               obj.owner = account_id_type( i );
+               obj.balance = i;
+            }).id );
+         ses.commit();
+      }
+      for( uint32_t i = 0; i < ids.size(); ++i )
+         BOOST_CHECK_EQUAL( ids[i](db).balance.value, i );
+
+      // removal leaves a hole, and undoing it fills the hole again
+      auto ses = db._undo_db.start_undo_session();
+      db.remove( ids[5000](db) );
+      BOOST_CHECK( db.find( ids[5000] ) == nullptr );
+      BOOST_CHECK( db.find( ids[4999] ) != nullptr );
+      BOOST_CHECK( db.find( account_balance_id_type( ids.size() ) ) == nullptr );
+      ses.undo();
+      BOOST_REQUIRE( db.find( ids[5000] ) != nullptr );
+      BOOST_CHECK_EQUAL( ids[5000](db).balance.value, 5000 );
+      BOOST_CHECK( &ids[5000](db) == &*db.get_index_type<account_balance_index>().indices().get<by_id>().find( ids[5000] ) );
+
+      // a modification violating a uniqueness constraint drops the object, and its slot with it
+      BOOST_CHECK_THROW( db.modify( ids[7](db), []( account_balance_object& obj ){ obj.owner = account_id_type( 8 ); } ),
+                         fc::exception );
+      BOOST_CHECK( db.find( ids[7] ) == nullptr );
+      BOOST_CHECK( db.find( ids[8] ) != nullptr );
+
+      // a chunk whose objects are all removed is freed, and allocated again when they come back
+      const account_balance_index& index = db.get_index_type<account_balance_index>();
+      const uint32_t chunk_size = account_balance_index::chunk_size;
+      BOOST_CHECK_EQUAL( index.allocated_chunks(), 3u );
+      auto remove_ses = db._undo_db.start_undo_session();
+      for( uint32_t i = chunk_size; i < 2 * chunk_size; ++i )
+         db.remove( ids[i](db) );
+      BOOST_CHECK_EQUAL( index.allocated_chunks(), 2u );
+      BOOST_CHECK( db.find( ids[chunk_size] ) == nullptr );
+      BOOST_CHECK( db.find( ids[2 * chunk_size] ) != nullptr );
+      remove_ses.undo();
+      BOOST_CHECK_EQUAL( index.allocated_chunks(), 3u );
+      BOOST_CHECK_EQUAL( ids[chunk_size](db).balance.value, chunk_size );
+   } catch ( const fc::exception& e )
+   {
+      edump( (e.to_detail_string()) );
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE( adjust_balance_after_undo_test )
+{
+   try {
+      database db;
+      const account_id_type alice( 100 );
+      const account_id_type bob( 101 );
+
+      // the balance object created for alice is undone and its id reused for bob
+      auto ses = db._undo_db.start_undo_session();
+      db.adjust_balance( alice, asset(10) );
+      ses.undo();
+      ses = db._undo_db.start_undo_session();
+      db.adjust_balance( bob, asset(5) );
+      db.adjust_balance( alice, asset(10) );
+      db.adjust_balance( alice, asset(-3) );
+
+      BOOST_CHECK_EQUAL( db.get_balance( alice, asset_id_type() ).amount.value, 7 );
+      BOOST_CHECK_EQUAL( db.get_balance( bob, asset_id_type() ).amount.value, 5 );
+      BOOST_REQUIRE( db.find_balance_object( alice, asset_id_type() ) != nullptr );
+      BOOST_CHECK( db.find_balance_object( alice, asset_id_type() )->owner == alice );
+      BOOST_CHECK( db.find_balance_object( bob, asset_id_type(1) ) == nullptr );
+   } catch ( const fc::exception& e )
+   {
+      edump( (e.to_detail_string()) );
+      throw;
+   }
+}
@@ -683,6 +683,49 @@ BOOST_AUTO_TEST_CASE( update_mia )
 }
 
 
+BOOST_AUTO_TEST_CASE( update_expired_feeds )
+{
+   try {
+      ACTORS( (issuer)(feeder) );
+      const asset_id_type bitusd_id = create_bitasset( "USDBIT", issuer_id ).id;
+      update_feed_producers( bitusd_id, {feeder_id} );
+
+      price_feed feed;
+      feed.settlement_price = bitusd_id(db).amount( 1 ) / asset( 5 );
+      feed.core_exchange_rate = bitusd_id(db).amount( 1 ) / asset( 3 );
+      publish_feed( bitusd_id, feeder_id, feed );
+      generate_block();
+      BOOST_CHECK( bitusd_id(db).options.core_exchange_rate == feed.core_exchange_rate );
+
+      // the core exchange rate follows the feed again in the next block when the issuer changes it
+      asset_update_operation op;
+      op.issuer = issuer_id;
+      op.asset_to_update = bitusd_id;
+      op.new_options = bitusd_id(db).options;
+      op.new_options.core_exchange_rate = bitusd_id(db).amount( 1 ) / asset( 7 );
+      trx.operations.push_back( op );
+      set_expiration( db, trx );
+      PUSH_TX( db, trx, ~0 );
+      trx.clear();
+      BOOST_CHECK( bitusd_id(db).options.core_exchange_rate == op.new_options.core_exchange_rate );
+      generate_block();
+      BOOST_CHECK( bitusd_id(db).options.core_exchange_rate == feed.core_exchange_rate );
+
+      // the feed is dropped once its lifetime is over
+      const asset_bitasset_data_object& bitasset = bitusd_id(db).bitasset_data(db);
+      const time_point_sec feed_expiration = bitasset.feed_expiration_time();
+      generate_blocks( feed_expiration - 60 );
+      BOOST_CHECK( bitasset.current_feed.settlement_price == feed.settlement_price );
+      generate_blocks( feed_expiration );
+      generate_block();
+      BOOST_CHECK( bitasset.current_feed.settlement_price.is_null() );
+      BOOST_CHECK( bitasset.feed_expiration_time() > db.head_block_time() );
+   } catch ( const fc::exception& e ) {
+      elog( "${e}", ("e", e.to_detail_string() ) );
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( create_uia )
 {
    try {
@@ -1420,6 +1463,124 @@ BOOST_AUTO_TEST_CASE( test_basic_dividend_distribution )
       throw;
    }
 }
+BOOST_AUTO_TEST_CASE( dividend_distribution_matches_reference )
+{
+   using namespace graphene;
+   try {
+      INVOKE( create_dividend_uia );
+
+      const auto& dividend_holder_asset_object = get_asset("DIVIDEND");
+      const auto& dividend_data = dividend_holder_asset_object.dividend_data(db);
+      const account_object& dividend_distribution_account = dividend_data.dividend_distribution_account(db);
+      const auto& test_asset_object = get_asset("TEST");
+      vector<account_id_type> holders = { get_account("alice").id, get_account("bob").id, get_account("carol").id,
+                                          get_account("dave").id, get_account("frank").id };
+
+      auto issue_asset_to_account = [&](const asset_object& asset_to_issue, account_id_type destination_account, int64_t amount_to_issue)
+      {
+         asset_issue_operation op;
+         op.issuer = asset_to_issue.issuer;
+         op.asset_to_issue = asset(amount_to_issue, asset_to_issue.id);
+         op.issue_to_account = destination_account;
+         trx.operations.push_back( op );
+         set_expiration(db, trx);
+         PUSH_TX( db, trx, ~0 );
+         trx.operations.clear();
+      };
+
+      // uneven holdings so the shares don't divide evenly, one holder also has part of its stake vesting,
+      // and the distribution account holds some of the asset itself
+      const int64_t holdings[] = { 33333, 100000, 7, 1234567, 0 };
+      for( size_t i = 0; i < holders.size(); ++i )
+         if( holdings[i] )
+            issue_asset_to_account(dividend_holder_asset_object, holders[i], holdings[i]);
+      issue_asset_to_account(dividend_holder_asset_object, holders[4], 50001);
+      {
+         cdd_vesting_policy_initializer pinit;
+         pinit.vesting_seconds = 60 * 60 * 24 * 30;
+         vesting_balance_create_operation op;
+         op.creator = holders[4];
+         op.owner = holders[4];
+         op.amount = asset(50000, dividend_holder_asset_object.id);
+         op.policy = pinit;
+         trx.operations.push_back( op );
+         set_expiration(db, trx);
+         PUSH_TX( db, trx, ~0 );
+         trx.operations.clear();
+      }
+      issue_asset_to_account(dividend_holder_asset_object, dividend_distribution_account.id, 99999);
+
+      // the pending payouts the dividend engine has always computed: every holder gets its share of the deposit
+      // less the distribution fee, rounded down, with vesting balances counted as held
+      std::map<account_id_type, int64_t> expected;
+      auto schedule_reference_payouts = [&]( int64_t deposit ) {
+         const auto& balance_idx = db.get_index_type<account_balance_index>().indices().get<by_asset_balance>();
+         auto holder_range = balance_idx.equal_range(boost::make_tuple(dividend_holder_asset_object.id));
+         const auto& fees = db.get_global_properties().parameters.current_fees->get<asset_dividend_distribution_operation>();
+         uint64_t fee_in_core = fees.distribution_base_fee
+                                + std::distance(holder_range.first, holder_range.second) * (uint64_t)fees.distribution_fee_per_holder;
+         int64_t delta = deposit - (asset(fee_in_core, asset_id_type()) * test_asset_object.options.core_exchange_rate).amount.value;
+
+         std::map<account_id_type, int64_t> balances;
+         for( const account_balance_object& b : boost::make_iterator_range(holder_range.first, holder_range.second) )
+            if( b.owner != dividend_distribution_account.id )
+               balances[b.owner] += b.balance.value;
+         for( const vesting_balance_object& vb : db.get_index_type<vesting_balance_index>().indices() )
+            if( vb.balance.asset_id == dividend_holder_asset_object.id && balances.count(vb.owner) )
+               balances[vb.owner] += vb.balance.amount.value;
+         int64_t total = 0;
+         for( const auto& b : balances )
+            total += b.second;
+         for( const auto& b : balances )
+         {
+            fc::uint128_t share(delta);
+            share *= b.second;
+            share /= total;
+            expected[b.first] += share.to_uint64();
+         }
+      };
+      auto verify_pending_balances = [&]() {
+         for( account_id_type holder : holders )
+            BOOST_CHECK_EQUAL( get_dividend_pending_payout_balance(dividend_holder_asset_object.id, holder, test_asset_object.id),
+                               expected[holder] );
+      };
+
+      generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+      generate_block();
+      BOOST_REQUIRE(dividend_data.options.next_payout_time);
+      const fc::time_point_sec payout_time = *dividend_data.options.next_payout_time;
+
+      // two distributions, usually both before the payout, the holdings change in between
+      issue_asset_to_account(test_asset_object, dividend_distribution_account.id, 1000003);
+      generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+      schedule_reference_payouts(1000003);
+      generate_block();
+      if( dividend_data.options.next_payout_time && *dividend_data.options.next_payout_time == payout_time )
+         verify_pending_balances();
+
+      issue_asset_to_account(dividend_holder_asset_object, holders[2], 4242);
+      issue_asset_to_account(test_asset_object, dividend_distribution_account.id, 77777);
+      generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+      schedule_reference_payouts(77777);
+      generate_block();
+      if( dividend_data.options.next_payout_time && *dividend_data.options.next_payout_time == payout_time )
+         verify_pending_balances();
+
+      // at the payout every pending balance ends up in the holder's account
+      generate_blocks(payout_time);
+      generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+      generate_block();
+      for( account_id_type holder : holders )
+      {
+         BOOST_CHECK_EQUAL( get_balance(holder, test_asset_object.id), expected[holder] );
+         BOOST_CHECK_EQUAL( get_dividend_pending_payout_balance(dividend_holder_asset_object.id, holder, test_asset_object.id), 0 );
+      }
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( test_dividend_distribution_interval )
 {
    using namespace graphene;
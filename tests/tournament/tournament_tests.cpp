@@ -2670,6 +2670,275 @@ BOOST_FIXTURE_TEST_CASE( massive, database_fixture )
 }
 #endif
 
+// Measures what undo (clone + move_from) and persistence (pack) cost for tournament,
+// match and game objects of a tournament in progress.
+BOOST_FIXTURE_TEST_CASE( tournament_objects_copy_benchmark, database_fixture )
+{
+    try
+    {
+#ifdef NDEBUG
+        const unsigned iterations = 1000000;
+#else
+        const unsigned iterations = 10000;
+#endif
+        ACTORS((nathan)(alice)(bob));
+        fc::ecc::private_key nathan_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("nathan")));
+        fc::ecc::private_key alice_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("alice")));
+        fc::ecc::private_key bob_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("bob")));
+        transfer(committee_account, nathan_id, asset(1000000000));
+        transfer(committee_account, alice_id, asset(1000000));
+        transfer(committee_account, bob_id, asset(1000000));
+        upgrade_to_lifetime_member(nathan);
+        generate_block();
+
+        tournaments_helper tournament_helper(*this);
+        asset buy_in = asset(1000);
+        tournament_id_type tournament_id = tournament_helper.create_tournament(nathan_id, nathan_priv_key, buy_in, 2, 30, 30);
+        tournament_helper.join_tournament(tournament_id, alice_id, alice_id, alice_priv_key, buy_in);
+        tournament_helper.join_tournament(tournament_id, bob_id, bob_id, bob_priv_key, buy_in);
+        generate_blocks(db.head_block_time() + fc::seconds(10));
+
+        const tournament_object& tournament = tournament_id(db);
+        BOOST_REQUIRE(tournament.get_state() == tournament_state::in_progress);
+        const match_object& match = tournament.tournament_details_id(db).matches[0](db);
+        const game_object& game = match.games[0](db);
+
+        const std::vector<std::pair<std::string, const object*>> objects = {
+            { "tournament", &tournament }, { "match", &match }, { "game", &game } };
+        for (const auto& item : objects)
+        {
+            fc::time_point start = fc::time_point::now();
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                std::unique_ptr<object> backup = item.second->clone();
+                std::unique_ptr<object> restored = item.second->clone();
+                restored->move_from(*backup);
+            }
+            fc::microseconds undo_time = fc::time_point::now() - start;
+
+            start = fc::time_point::now();
+            size_t packed_size = 0;
+            for (unsigned i = 0; i < iterations; ++i)
+                packed_size += item.second->pack().size();
+            fc::microseconds pack_time = fc::time_point::now() - start;
+
+            BOOST_TEST_MESSAGE(item.first + ": " + std::to_string(iterations) + " clone/move_from in " +
+                               std::to_string(undo_time.count() / 1000) + " ms, pack in " +
+                               std::to_string(pack_time.count() / 1000) + " ms (" +
+                               std::to_string(packed_size / iterations) + " bytes each)");
+        }
+
+        // the moved-to copy must carry the state machine along
+        std::unique_ptr<object> backup = match.clone();
+        std::unique_ptr<object> restored = game.clone();
+        match_object moved(std::move(static_cast<match_object&>(*backup)));
+        BOOST_CHECK(moved.get_state() == match.get_state());
+        game_object moved_game;
+        moved_game = std::move(static_cast<game_object&>(*restored));
+        BOOST_CHECK(moved_game.get_state() == game.get_state());
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+static const match_object& tournament_match(const database& db, const tournament_id_type& tournament_id, unsigned index)
+{
+    return tournament_id(db).tournament_details_id(db).matches.at(index)(db);
+}
+
+static bool first_round_complete(const database& db, const tournament_id_type& tournament_id)
+{
+    return tournament_match(db, tournament_id, 0).get_state() == match_state::match_complete &&
+           tournament_match(db, tournament_id, 1).get_state() == match_state::match_complete;
+}
+
+static bool final_match_started(const database& db, const tournament_id_type& tournament_id)
+{
+    const match_object& final_match = tournament_match(db, tournament_id, 2);
+    return final_match.get_state() != match_state::waiting_on_previous_matches && final_match.players.size() == 2;
+}
+
+// a four player tournament in which nobody moves, so every game ends by timeout
+struct timeout_tournament_fixture : database_fixture
+{
+    timeout_tournament_fixture() : tournament_helper(*this)
+    {
+        ACTORS((nathan)(alice)(bob)(carol)(dave));
+        transfer(committee_account, nathan_id, asset(1000000000));
+        transfer(committee_account, alice_id, asset(1000000));
+        transfer(committee_account, bob_id, asset(1000000));
+        transfer(committee_account, carol_id, asset(1000000));
+        transfer(committee_account, dave_id, asset(1000000));
+        upgrade_to_lifetime_member(nathan);
+
+        const asset buy_in = asset(1000);
+        tournament_id = tournament_helper.create_tournament(nathan_id, nathan_private_key, buy_in, 4, 3, 1, 1);
+        tournament_helper.join_tournament(tournament_id, alice_id, alice_id, alice_private_key, buy_in);
+        tournament_helper.join_tournament(tournament_id, bob_id, bob_id, bob_private_key, buy_in);
+        tournament_helper.join_tournament(tournament_id, carol_id, carol_id, carol_private_key, buy_in);
+        tournament_helper.join_tournament(tournament_id, dave_id, dave_id, dave_private_key, buy_in);
+    }
+
+    /// generates blocks until the games of the first round have all timed out, @return the block completing it
+    signed_block generate_until_first_round_complete()
+    {
+        signed_block completing_block;
+        for (unsigned i = 0; i < 200 && !first_round_complete(db, tournament_id); ++i)
+            completing_block = generate_block();
+        BOOST_REQUIRE(first_round_complete(db, tournament_id));
+        return completing_block;
+    }
+
+    tournaments_helper tournament_helper;
+    tournament_id_type tournament_id;
+};
+
+// The matches of the next round have to start right after the first round ended by timeouts,
+// at the latest in the following block
+BOOST_FIXTURE_TEST_CASE( next_round_starts_after_timeouts, timeout_tournament_fixture )
+{
+    try
+    {
+        generate_until_first_round_complete();
+
+        generate_block();
+        BOOST_CHECK(final_match_started(db, tournament_id));
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+// The same across undo: popping the blocks and applying or generating them again must still
+// start the next round
+BOOST_FIXTURE_TEST_CASE( next_round_starts_after_timeouts_across_undo, timeout_tournament_fixture )
+{
+    try
+    {
+        signed_block completing_block = generate_until_first_round_complete();
+
+        db.pop_block();
+        BOOST_CHECK(!first_round_complete(db, tournament_id));
+        BOOST_CHECK(!final_match_started(db, tournament_id));
+        PUSH_BLOCK(db, completing_block, ~0);
+        BOOST_REQUIRE(first_round_complete(db, tournament_id));
+        generate_block();
+        BOOST_CHECK(final_match_started(db, tournament_id));
+
+        // undo both blocks and produce them again
+        db.pop_block();
+        db.pop_block();
+        BOOST_CHECK(!first_round_complete(db, tournament_id));
+        generate_block();
+        BOOST_REQUIRE(first_round_complete(db, tournament_id));
+        generate_block();
+        BOOST_CHECK(final_match_started(db, tournament_id));
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+// The same after the node restarted: the tournaments with changed matches are not saved, a database
+// opened from disk has to find the next round to start on its own
+BOOST_FIXTURE_TEST_CASE( next_round_starts_after_timeouts_after_reopen, timeout_tournament_fixture )
+{
+    try
+    {
+        signed_block completing_block = generate_until_first_round_complete();
+
+        // a second node applies the chain up to the end of the first round and is restarted
+        const uint32_t skip = database::skip_transaction_signatures | database::skip_authority_check;
+        fc::temp_directory data_dir2( graphene::utilities::temp_directory_path() );
+        {
+            database db2;
+            db2.open(data_dir2.path(), [this]{ return genesis_state; });
+            for (uint32_t num = 1; num <= db.head_block_num(); ++num)
+                PUSH_BLOCK(db2, *db.fetch_block_by_number(num), skip);
+            db2.close(false);
+        }
+        database db3;
+        db3.open(data_dir2.path(), [this]{ return genesis_state; });
+        BOOST_REQUIRE(db3.head_block_id() == completing_block.id());
+        BOOST_REQUIRE(first_round_complete(db3, tournament_id));
+
+        PUSH_BLOCK(db3, generate_block(), skip);
+        BOOST_CHECK(final_match_started(db, tournament_id));
+        BOOST_CHECK(final_match_started(db3, tournament_id));
+        BOOST_CHECK(tournament_match(db3, tournament_id, 2).players == tournament_match(db, tournament_id, 2).players);
+        BOOST_CHECK(db3.head_block_id() == db.head_block_id());
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+// Measures the per-block cost of many tournaments being in progress at once while
+// nothing happens in them (every game is waiting for commit moves).
+BOOST_FIXTURE_TEST_CASE( concurrent_tournaments_benchmark, database_fixture )
+{
+    try
+    {
+#ifdef NDEBUG
+        const unsigned number_of_tournaments = 10000;
+#else
+        const unsigned number_of_tournaments = 200;
+#endif
+        const unsigned tournaments_per_block = 100;
+        const unsigned blocks_to_measure = 5;
+
+        ACTORS((nathan)(alice)(bob));
+        fc::ecc::private_key nathan_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("nathan")));
+        fc::ecc::private_key alice_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("alice")));
+        fc::ecc::private_key bob_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("bob")));
+        transfer(committee_account, nathan_id, asset(1000000000));
+        transfer(committee_account, alice_id, asset(100000000));
+        transfer(committee_account, bob_id, asset(100000000));
+        upgrade_to_lifetime_member(nathan);
+        generate_block();
+
+        tournaments_helper tournament_helper(*this);
+        asset buy_in = asset(1000);
+        for (unsigned i = 0; i < number_of_tournaments; ++i)
+        {
+            tournament_id_type tournament_id = tournament_helper.create_tournament(nathan_id, nathan_priv_key, buy_in, 2, 30, 30);
+            tournament_helper.join_tournament(tournament_id, alice_id, alice_id, alice_priv_key, buy_in);
+            tournament_helper.join_tournament(tournament_id, bob_id, bob_id, bob_priv_key, buy_in);
+            if (i % tournaments_per_block == tournaments_per_block - 1)
+                generate_block();
+        }
+
+        // wait for all tournaments to start
+        generate_blocks(db.head_block_time() + fc::seconds(10));
+        unsigned in_progress = 0;
+        for (const tournament_id_type& tournament_id : tournament_helper.list_tournaments())
+            if (tournament_id(db).get_state() == tournament_state::in_progress)
+                ++in_progress;
+        BOOST_CHECK_EQUAL(in_progress, number_of_tournaments);
+
+        fc::time_point start = fc::time_point::now();
+        for (unsigned i = 0; i < blocks_to_measure; ++i)
+            generate_block();
+        fc::microseconds elapsed = fc::time_point::now() - start;
+        BOOST_TEST_MESSAGE("Generated " + std::to_string(blocks_to_measure) + " blocks with " + std::to_string(in_progress) +
+                           " tournaments in progress in " + std::to_string(elapsed.count() / 1000) + " milliseconds");
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 //#define BOOST_TEST_MODULE "C++ Unit Tests for Graphene Blockchain Database"